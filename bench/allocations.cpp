@@ -0,0 +1,97 @@
+// Checks that tracing rays does no heap allocation, and reports the allocations and the bytes of vector
+// data copied per camera ray. Fails if the number of allocations grows with the number of rays.
+//
+// Built with RT_INSTRUMENT and the allocation hook of instrumentation.cpp, so it compiles the renderer
+// on its own instead of linking rt_core.
+
+#include <iostream>
+#include <string>
+
+#include "camera.hpp"
+#include "hittable_list.hpp"
+#include "instrumentation.hpp"
+#include "radiance_cache.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto low_samples = 1;
+constexpr auto high_samples = 4;
+
+/// @return Counters after rendering the scene, relative to the ones before
+auto count_render(camera<scalar> &cam, const hittable_list<scalar> &world, const hittable_list<scalar> &lights,
+                  const int samples_per_pixel) -> rt::instrumentation::counters
+{
+    cam.samples_per_pixel = samples_per_pixel;
+    rt::seed();
+
+    const auto before = rt::instrumentation::thread_counters();
+    cam.render_image(world, lights);
+    const auto after = rt::instrumentation::thread_counters();
+
+    return {after.allocations - before.allocations, after.bytes_allocated - before.bytes_allocated,
+            after.bytes_copied - before.bytes_copied};
+}
+
+/// @return true if no allocation depends on the number of rays traced
+auto check(const std::string &name, camera<scalar> cam, const hittable_list<scalar> &world) -> bool
+{
+    const auto lights = world.lights();
+    const auto low = count_render(cam, world, lights, low_samples);
+    const auto high = count_render(cam, world, lights, high_samples);
+
+    // Images have the same size, so any difference comes from the extra rays
+    const auto image_height = static_cast<int>(cam.image_width / cam.aspect_ratio);
+    const auto extra_rays = static_cast<double>(cam.image_width * image_height * (high_samples - low_samples));
+    const auto per_ray = [&](const auto high_value, const auto low_value) {
+        return (static_cast<double>(high_value) - static_cast<double>(low_value)) / extra_rays;
+    };
+
+    std::cout << name << ": " << per_ray(high.allocations, low.allocations) << " allocations, "
+              << per_ray(high.bytes_allocated, low.bytes_allocated) << " bytes allocated, "
+              << per_ray(high.bytes_copied, low.bytes_copied) << " bytes copied per camera ray ("
+              << low.allocations << " allocations per render)\n";
+
+    return high.allocations == low.allocations;
+}
+} // namespace
+
+auto main() -> int
+{
+    auto ok = true;
+
+    {
+        rt::seed();
+        const auto world = random_spheres_scene<scalar>();
+        auto cam = random_spheres_camera<scalar>();
+        cam.image_width = 64;
+        ok = check("random_spheres", cam, world) && ok;
+    }
+
+    {
+        // The cache table is allocated up front, so filling it while rendering must not allocate either
+        rt::seed();
+        const auto world = random_spheres_scene<scalar>();
+        auto cache = radiance_cache<scalar>{0.2, std::size_t{1} << 16};
+        auto cam = random_spheres_camera<scalar>();
+        cam.image_width = 64;
+        cam.indirect_cache = &cache;
+        ok = check("random_spheres_cached", cam, world) && ok;
+    }
+
+    {
+        const auto world = small_light_scene<scalar>();
+        auto cam = small_light_camera<scalar>();
+        cam.image_width = 32;
+        ok = check("small_light", cam, world) && ok;
+    }
+
+    if (!ok) {
+        std::cout << "FAILED: the render loop allocates per ray\n";
+        return 1;
+    }
+}
\ No newline at end of file
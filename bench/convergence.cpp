@@ -0,0 +1,222 @@
+// Convergence regression harness. Renders a set of canonical scenes with fixed sample counts,
+// compares them with stored high sample count references and reports the efficiency of each
+// render as 1 / (relMSE * seconds), which is independent of the sample count for unbiased estimators.
+//
+//   rt_converge update <dir>               Renders the references, records the error of the test renders
+//                                          and the baseline efficiency
+//   rt_converge check <dir> [threshold]    Fails if the error of any scene grew, or its efficiency dropped,
+//                                          by more than threshold (default 0.2) relative to the recorded ones
+//
+// Every render is seeded, so references and errors are reproducible and kept under version control, in
+// bench/references. The baseline efficiency depends on the speed of the machine, so it is only recorded
+// locally and the efficiency is not checked without it.
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto reference_samples = 512;
+constexpr auto reference_seed = 1u;
+constexpr auto test_seed = 2u;
+constexpr auto timing_runs = 3;
+constexpr auto errors_file = "errors.txt";
+constexpr auto baseline_file = "baseline.txt";
+
+struct test_scene
+{
+    std::string name;
+    hittable_list<scalar> world;
+    hittable_list<scalar> lights;
+    camera<scalar> cam;
+    int test_samples;   // Samples per pixel of test renders, enough for a stable timing
+};
+
+struct measurement
+{
+    scalar rmse;
+    scalar relmse;
+    double seconds;
+
+    auto efficiency() const -> double
+    {
+        return 1. / (relmse * seconds);
+    }
+};
+
+auto make_scenes() -> std::vector<test_scene>
+{
+    auto scenes = std::vector<test_scene>{};
+    rt::seed();
+
+    // Final scene of main.cpp, at a reduced resolution
+    {
+        auto world = random_spheres_scene<scalar>();
+        auto lights = world.lights();
+        auto cam = random_spheres_camera<scalar>();
+        cam.image_width = 96;
+        scenes.push_back({"random_spheres", std::move(world), std::move(lights), std::move(cam), 16});
+    }
+
+    {
+        auto world = small_light_scene<scalar>();
+        auto lights = world.lights();
+        auto cam = small_light_camera<scalar>();
+        cam.image_width = 64;
+        scenes.push_back({"small_light", std::move(world), std::move(lights), std::move(cam), 128});
+    }
+
+    return scenes;
+}
+
+auto render(test_scene &scene, const int samples_per_pixel, const unsigned seed) -> framebuffer<scalar>
+{
+    // Seeded, so the error of each render is reproducible and only its time varies between runs
+    scene.cam.samples_per_pixel = samples_per_pixel;
+    rt::seed(seed);
+    return scene.cam.render_image(scene.world, scene.lights);
+}
+
+/// @return Test render of the scene, and the shortest time of several identical runs to filter out noise
+auto timed_render(test_scene &scene) -> std::pair<framebuffer<scalar>, double>
+{
+    auto seconds = std::numeric_limits<double>::max();
+    for (auto run = 0; run < timing_runs - 1; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        render(scene, scene.test_samples, test_seed);
+        seconds = std::min(seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    auto image = render(scene, scene.test_samples, test_seed);
+    seconds = std::min(seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    return {std::move(image), seconds};
+}
+
+auto measure(test_scene &scene, const std::filesystem::path &dir) -> measurement
+{
+    auto in = std::ifstream{dir / (scene.name + ".pfm"), std::ios::binary};
+    if (!in) {
+        throw std::runtime_error{"Missing reference for scene " + scene.name};
+    }
+    const auto reference = framebuffer<scalar>::read_pfm(in);
+
+    const auto [image, seconds] = timed_render(scene);
+    const auto result = measurement{rmse(image, reference), relmse(image, reference), seconds};
+
+    std::cout << scene.name << ": " << scene.test_samples << " spp in " << seconds << " s, RMSE " << result.rmse
+              << ", relMSE " << result.relmse << ", efficiency " << result.efficiency() << '\n';
+    return result;
+}
+
+auto update(const std::filesystem::path &dir) -> int
+{
+    std::filesystem::create_directories(dir);
+
+    auto scenes = make_scenes();
+    for (auto &scene : scenes) {
+        std::cout << scene.name << ": rendering reference with " << reference_samples << " spp\n";
+        const auto reference = render(scene, reference_samples, reference_seed);
+        auto out = std::ofstream{dir / (scene.name + ".pfm"), std::ios::binary};
+        reference.write_pfm(out);
+    }
+
+    auto errors = std::ofstream{dir / errors_file};
+    errors.precision(std::numeric_limits<double>::max_digits10);
+    auto baseline = std::ofstream{dir / baseline_file};
+    for (auto &scene : scenes) {
+        const auto result = measure(scene, dir);
+        errors << scene.name << ' ' << result.relmse << '\n';
+        baseline << scene.name << ' ' << result.efficiency() << '\n';
+    }
+    return 0;
+}
+
+/// @return Value recorded for each scene in a file of "<scene name> <value>" lines, empty if there is no file
+auto read_values(const std::filesystem::path &path) -> std::map<std::string, double>
+{
+    auto values = std::map<std::string, double>{};
+    auto in = std::ifstream{path};
+    auto name = std::string{};
+    auto value = 0.;
+    while (in >> name >> value) {
+        values[name] = value;
+    }
+    return values;
+}
+
+auto check(const std::filesystem::path &dir, const double threshold) -> int
+{
+    const auto errors = read_values(dir / errors_file);
+    const auto baseline = read_values(dir / baseline_file);
+    if (baseline.empty()) {
+        std::cout << "No baseline recorded, checking errors only\n";
+    }
+
+    auto failures = 0;
+    auto scenes = make_scenes();
+    for (auto &scene : scenes) {
+        const auto result = measure(scene, dir);
+
+        // Catches biased changes, which converge to a different image than the reference
+        const auto error = errors.find(scene.name);
+        if (error == errors.end()) {
+            std::cout << "  FAILED: no error recorded\n";
+            ++failures;
+        } else {
+            const auto ratio = result.relmse / error->second;
+            std::cout << "  " << ratio << "x recorded relMSE\n";
+            if (ratio > 1. + threshold) {
+                std::cout << "  FAILED: relMSE grew by more than " << threshold * 100. << "%\n";
+                ++failures;
+            }
+        }
+
+        const auto efficiency = baseline.find(scene.name);
+        if (efficiency != baseline.end()) {
+            const auto ratio = result.efficiency() / efficiency->second;
+            std::cout << "  " << ratio << "x baseline efficiency\n";
+            if (ratio < 1. - threshold) {
+                std::cout << "  FAILED: efficiency dropped by more than " << threshold * 100. << "%\n";
+                ++failures;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int
+{
+    const auto args = std::vector<std::string>(argv, argv + argc);
+    if (args.size() < 3 || (args[1] != "update" && args[1] != "check")) {
+        std::cerr << "Usage: " << args[0] << " update|check <dir> [threshold]\n";
+        return 2;
+    }
+
+    try {
+        if (args[1] == "update") {
+            return update(args[2]);
+        }
+        return check(args[2], args.size() > 3 ? std::stod(args[3]) : 0.2);
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 2;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Compares the two-phase intersection path (distance-only closest hit search followed by a single
+// finalization) against the eager path that builds a full hit record for every closer hit found.
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "hittable.hpp"
+#include "hittable_list.hpp"
+#include "random.hpp"
+#include "ray.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+#include "vec3.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto ray_count = 200'000;
+constexpr auto surface_epsilon = 0.001;
+
+/// Rays from around the main.cpp camera position towards random points of the scene
+auto make_rays() -> std::vector<ray<scalar>>
+{
+    auto rays = std::vector<ray<scalar>>{};
+    rays.reserve(ray_count);
+
+    for (auto i = 0; i < ray_count; ++i) {
+        const auto origin = static_cast<coord<scalar>>(coord{13., 2., 3.} + rt::random_v(-0.5, 0.5));
+        const auto target = coord{rt::random_t(-11., 11.), rt::random_t(-0.5, 1.5), rt::random_t(-11., 11.)};
+        rays.push_back({origin, target - origin});
+    }
+    return rays;
+}
+
+/// Closest hit search that finalizes every closer hit, as each primitive's hit() does on its own
+auto eager_hit(const hittable_list<scalar> &world, const ray<scalar> r, const interval<scalar> ray_t)
+    -> std::optional<hit_record<scalar>>
+{
+    auto closest_so_far = ray_t.max;
+    auto rec = std::optional<hit_record<scalar>>{};
+
+    for (const auto &obj : world.objects) {
+        if (auto rec_found = obj->hit(r, {ray_t.min, closest_so_far})) {
+            rec = std::move(rec_found);
+            closest_so_far = rec->t;
+        }
+    }
+    return rec;
+}
+
+template<typename F>
+auto measure(const char *name, const std::vector<ray<scalar>> &rays, F query) -> void
+{
+    auto checksum = 0.;
+    const auto start = std::chrono::steady_clock::now();
+    for (const auto &r : rays) {
+        checksum += query(r);
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": " << elapsed * 1e9 / ray_count << " ns/ray"
+              << " (" << ray_count / elapsed * 1e-6 << " Mrays/s, checksum " << checksum << ")\n";
+}
+} // namespace
+
+auto main() -> int
+{
+    const auto world = random_spheres_scene<scalar>();
+    const auto rays = make_rays();
+    const auto ray_t = interval<scalar>{surface_epsilon, rt::infinity};
+
+    std::cout << world.objects.size() << " objects, " << ray_count << " rays\n";
+
+    measure("eager hit       ", rays, [&](const auto &r) {
+        const auto rec = eager_hit(world, r, ray_t);
+        return rec ? rec->t + rec->normal.y() : 0.;
+    });
+    measure("two-phase hit   ", rays, [&](const auto &r) {
+        const auto rec = world.hit(r, ray_t);
+        return rec ? rec->t + rec->normal.y() : 0.;
+    });
+    measure("closest_hit only", rays, [&](const auto &r) {
+        const auto candidate = world.closest_hit(r, ray_t);
+        return candidate ? candidate->t : 0.;
+    });
+    measure("any_hit         ", rays, [&](const auto &r) {
+        return world.any_hit(r, ray_t) ? 1. : 0.;
+    });
+}
\ No newline at end of file
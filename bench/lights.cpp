@@ -0,0 +1,66 @@
+// Measures the efficiency of next event estimation with multiple importance sampling against pure
+// BSDF sampling, as RMSE per second on a scene lit by a single small light.
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto reference_samples = 1024;
+constexpr auto test_samples = 16;
+constexpr auto test_seed = 2u;
+constexpr auto timing_runs = 5;
+
+auto make_camera(const int samples_per_pixel) -> camera<scalar>
+{
+    auto cam = small_light_camera<scalar>();
+    cam.image_width = 48;
+    cam.samples_per_pixel = samples_per_pixel;
+    return cam;
+}
+
+auto measure(const char *name, const hittable_list<scalar> &world, const hittable_list<scalar> &lights,
+             const framebuffer<scalar> &reference) -> void
+{
+    auto cam = make_camera(test_samples);
+
+    // Seeded, so every run renders the same image and only the shortest time is kept, to filter out noise
+    auto image = framebuffer<scalar>{1, 1};
+    auto elapsed = std::numeric_limits<double>::max();
+    for (auto run = 0; run < timing_runs; ++run) {
+        rt::seed(test_seed);
+        const auto start = std::chrono::steady_clock::now();
+        image = cam.render_image(world, lights);
+        elapsed = std::min(elapsed, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    // Variance, hence MSE, is inversely proportional to the time spent, so MSE * time is comparable
+    const auto error = rmse(image, reference);
+    std::cout << name << ": " << test_samples << " spp in " << elapsed << " s, RMSE " << error
+              << ", efficiency 1/(MSE*s) " << 1. / (error * error * elapsed) << '\n';
+}
+} // namespace
+
+auto main() -> int
+{
+    const auto world = small_light_scene<scalar>();
+    const auto lights = world.lights();
+
+    std::cout << "Rendering reference with " << reference_samples << " spp\n";
+    auto reference_cam = make_camera(reference_samples);
+    const auto reference = reference_cam.render_image(world, lights);
+
+    measure("BSDF sampling   ", world, hittable_list<scalar>{}, reference);
+    measure("NEE + MIS       ", world, lights, reference);
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+// Measures the speedup and the bias of the radiance cache for diffuse indirect bounces on the random spheres
+// scene, against the unbiased integrator, for several cell sizes. Besides the render time, reports the
+// closest hit queries traced, which unlike the time does not depend on the load of the machine.
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <optional>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable.hpp"
+#include "hittable_list.hpp"
+#include "radiance_cache.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto reference_samples = 256;
+constexpr auto test_samples = 16;
+constexpr auto timing_runs = 3;
+constexpr auto max_entries = std::size_t{1} << 16;  // Enough for every cell at the smallest size
+
+/// Forwards to the world, counting the closest hit queries
+class counting_world : public hittable<scalar>
+{
+public:
+    explicit counting_world(const hittable_list<scalar> &t_world) : m_world{t_world} {}
+
+    auto closest_hit(const ray<scalar> &r, const interval<scalar> ray_t) const -> std::optional<hit_candidate<scalar>> override
+    {
+        ++m_queries;
+        return m_world.closest_hit(r, ray_t);
+    }
+
+    auto finalize(const ray<scalar> &r, const hit_candidate<scalar> candidate) const -> hit_record<scalar> override
+    {
+        return m_world.finalize(r, candidate);
+    }
+
+    auto any_hit(const ray<scalar> &r, const interval<scalar> ray_t) const -> bool override
+    {
+        return m_world.any_hit(r, ray_t);
+    }
+
+    auto queries() const -> std::size_t
+    {
+        return m_queries;
+    }
+
+    auto reset() -> void
+    {
+        m_queries = 0;
+    }
+
+private:
+    const hittable_list<scalar> &m_world;
+    mutable std::size_t m_queries{0};
+};
+
+struct measurement
+{
+    framebuffer<scalar> image;
+    double seconds;
+    std::size_t queries;
+    double hit_rate;
+};
+
+/// @return Mean linear radiance over the whole image
+auto mean_radiance(const framebuffer<scalar> &image) -> scalar
+{
+    auto sum = scalar{};
+    for (auto j = 0; j < image.height(); ++j) {
+        for (auto i = 0; i < image.width(); ++i) {
+            const auto v = image.value(i, j);
+            sum += v.r() + v.g() + v.b();
+        }
+    }
+    return sum / (3 * static_cast<scalar>(image.width()) * static_cast<scalar>(image.height()));
+}
+
+/// Renders several times with the same seed, each time with an empty cache if cell_size is set
+/// @return Last render, with the shortest time of all runs to filter out noise
+auto measure(camera<scalar> cam, counting_world &world, const std::optional<scalar> cell_size) -> measurement
+{
+    auto result = measurement{framebuffer<scalar>{1, 1}, std::numeric_limits<double>::max(), 0, 0.};
+    for (auto run = 0; run < timing_runs; ++run) {
+        auto cache = std::optional<radiance_cache<scalar>>{};
+        if (cell_size) {
+            cam.indirect_cache = &cache.emplace(*cell_size, max_entries);
+        }
+
+        rt::seed(2);
+        world.reset();
+        const auto start = std::chrono::steady_clock::now();
+        result.image = cam.render_image(world, hittable_list<scalar>{});
+        result.seconds = std::min(result.seconds, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        result.queries = world.queries();
+        if (cache) {
+            result.hit_rate = static_cast<double>(cache->hits()) / static_cast<double>(cache->hits() + cache->misses());
+        }
+    }
+    return result;
+}
+} // namespace
+
+auto main() -> int
+{
+    rt::seed();
+    const auto world = random_spheres_scene<scalar>();
+    auto counted = counting_world{world};
+
+    auto cam = random_spheres_camera<scalar>();
+    cam.image_width = 96;
+
+    std::cout << "Rendering reference with " << reference_samples << " spp\n";
+    cam.samples_per_pixel = reference_samples;
+    rt::seed(1);
+    const auto reference = cam.render_image(world, hittable_list<scalar>{});
+    const auto reference_mean = mean_radiance(reference);
+
+    cam.samples_per_pixel = test_samples;
+    const auto unbiased = measure(cam, counted, std::nullopt);
+    std::cout << "Unbiased          : " << unbiased.seconds << " s, " << unbiased.queries << " queries, RMSE "
+              << rmse(unbiased.image, reference) << ", bias " << mean_radiance(unbiased.image) - reference_mean << '\n';
+
+    for (const auto cell_size : {0.05, 0.1, 0.2, 0.4}) {
+        const auto cached = measure(cam, counted, cell_size);
+        std::cout << "Cache, cell " << cell_size << " : " << cached.seconds << " s (" << unbiased.seconds / cached.seconds
+                  << "x), " << cached.queries << " queries ("
+                  << static_cast<double>(unbiased.queries) / static_cast<double>(cached.queries) << "x fewer), RMSE "
+                  << rmse(cached.image, reference) << ", bias " << mean_radiance(cached.image) - reference_mean << ", "
+                  << cached.hit_rate * 100. << "% hits\n";
+    }
+}
\ No newline at end of file
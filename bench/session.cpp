@@ -0,0 +1,76 @@
+// Edits spheres and materials of the random spheres scene in an interactive session, and reports for each
+// edit the fraction of tiles reused from the previous render and the time taken, against a full render.
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "camera.hpp"
+#include "material.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+#include "session.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+template<typename F>
+auto timed(F f) -> std::pair<decltype(f()), double>
+{
+    const auto start = std::chrono::steady_clock::now();
+    auto result = f();
+    return {std::move(result), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+}
+
+auto report(const char *name, const render_session<scalar>::edit_stats stats, const double seconds, const double full_seconds) -> void
+{
+    std::cout << name << ": " << stats.tiles_rendered << '/' << stats.tile_count << " tiles rendered, "
+              << stats.reused_fraction() * 100. << "% reused, " << seconds << " s (" << full_seconds / seconds
+              << "x faster than a full render)\n";
+}
+} // namespace
+
+auto main() -> int
+{
+    rt::seed();
+    auto world = random_spheres_scene<scalar>();
+
+    auto cam = random_spheres_camera<scalar>();
+    cam.image_width = 192;
+    cam.samples_per_pixel = 8;
+    cam.max_depth = 10;
+
+    auto [session, full_seconds] = timed([&] { return std::make_unique<render_session<scalar>>(world, cam); });
+    std::cout << "Full render: " << full_seconds << " s\n";
+
+    // Small spheres are added after the ground, and the three large ones last
+    const auto small_sphere = std::size_t{1};
+    const auto last = session->sphere_count() - 1;
+
+    {
+        const auto mat = std::make_shared<lambertian<scalar>>(color{0.9, 0.1, 0.1});
+        const auto [stats, seconds] = timed([&] { return session->set_material(small_sphere, mat); });
+        report("Small sphere material", stats, seconds, full_seconds);
+    }
+    {
+        const auto &s = session->sphere_at(small_sphere);
+        const auto center = static_cast<coord<scalar>>(s.m_center + vec3<scalar>{0., 0., 0.3});
+        const auto radius = s.m_radius;
+        const auto [stats, seconds] = timed([&] { return session->move_sphere(small_sphere, center, radius); });
+        report("Small sphere move", stats, seconds, full_seconds);
+    }
+    {
+        const auto *old_mat = session->sphere_at(last).m_material.get();
+        const auto mat = std::make_shared<metal<scalar>>(color{0.7, 0.6, 0.5}, 0.3);
+        const auto [stats, seconds] = timed([&] { return session->replace_material(old_mat, mat); });
+        report("Large metal fuzz", stats, seconds, full_seconds);
+    }
+    {
+        const auto *old_mat = session->sphere_at(0).m_material.get();
+        const auto mat = std::make_shared<lambertian<scalar>>(color{0.3, 0.5, 0.3});
+        const auto [stats, seconds] = timed([&] { return session->replace_material(old_mat, mat); });
+        report("Ground albedo", stats, seconds, full_seconds);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,187 @@
+// Checks that the images of an interactive session stay correct across edits. After each kind of edit, the
+// tiles the session did not render again must be bit-identical to before, and no tile may differ from a fresh
+// session of the edited scene by more than the noise between two fresh sessions with different seeds.
+// Fails if any edit breaks either property.
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "material.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+#include "session.hpp"
+#include "sphere.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto tile_size = 8;
+constexpr auto session_seed = 1u;
+constexpr auto fresh_seed = 2u;
+constexpr auto noise_seed = 3u;
+constexpr auto noise_tolerance = 1.5;   // Allowed tile error, relative to the largest one between fresh sessions
+
+/// @return Largest RMSE between the tiles of both images
+auto max_tile_rmse(const framebuffer<scalar> &a, const framebuffer<scalar> &b) -> scalar
+{
+    auto max_error = scalar{0};
+    for (auto y0 = 0; y0 < a.height(); y0 += tile_size) {
+        for (auto x0 = 0; x0 < a.width(); x0 += tile_size) {
+            auto sum = scalar{0};
+            auto count = 0;
+            for (auto j = y0; j < std::min(y0 + tile_size, a.height()); ++j) {
+                for (auto i = x0; i < std::min(x0 + tile_size, a.width()); ++i) {
+                    const auto d = a.value(i, j) - b.value(i, j);
+                    sum += d.length_squared() / 3;
+                    ++count;
+                }
+            }
+            max_error = std::max(max_error, std::sqrt(sum / static_cast<scalar>(count)));
+        }
+    }
+    return max_error;
+}
+
+/// @return true if the tiles that were not rendered again kept all their pixels
+auto kept_tiles_unchanged(const framebuffer<scalar> &before, const framebuffer<scalar> &after,
+                          const render_session<scalar>::edit_stats &stats) -> bool
+{
+    auto t = std::size_t{0};
+    for (auto y0 = 0; y0 < before.height(); y0 += tile_size) {
+        for (auto x0 = 0; x0 < before.width(); x0 += tile_size, ++t) {
+            if (stats.rendered[t]) {
+                continue;
+            }
+            for (auto j = y0; j < std::min(y0 + tile_size, before.height()); ++j) {
+                for (auto i = x0; i < std::min(x0 + tile_size, before.width()); ++i) {
+                    const auto p = before.pixel_at(i, j);
+                    const auto q = after.pixel_at(i, j);
+                    if (p.samples_per_pixel != q.samples_per_pixel || p.pixel_color.r() != q.pixel_color.r()
+                        || p.pixel_color.g() != q.pixel_color.g() || p.pixel_color.b() != q.pixel_color.b()) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/// Applies edits both to a session and to a copy of its world, which is rendered from scratch to check them
+class checker
+{
+public:
+    checker(const hittable_list<scalar> &t_world, const camera<scalar> &t_camera)
+        : m_world{t_world}, m_camera{t_camera}
+    {
+        rt::seed(session_seed);
+        m_session = std::make_unique<render_session<scalar>>(m_world, m_camera, tile_size);
+    }
+
+    auto session() -> render_session<scalar> &
+    {
+        return *m_session;
+    }
+
+    /// Replaces a sphere of the copy of the world, to match an edit of the session
+    auto set_sphere(const std::size_t index, const coord<scalar> &center, const scalar radius,
+                    std::shared_ptr<material<scalar>> mat) -> void
+    {
+        m_world.objects[index] = std::make_shared<sphere<scalar>>(center, radius, std::move(mat));
+    }
+
+    /// Runs the edit on the session and checks its image
+    /// @return true if the image is correct
+    template<typename F>
+    auto check(const std::string &name, F edit) -> bool
+    {
+        const auto before = m_session->image();
+        const auto stats = edit(*m_session);
+        const auto &after = m_session->image();
+
+        rt::seed(fresh_seed);
+        const auto fresh = render_session<scalar>{m_world, m_camera, tile_size};
+        rt::seed(noise_seed);
+        const auto noise = render_session<scalar>{m_world, m_camera, tile_size};
+
+        const auto kept = kept_tiles_unchanged(before, after, stats);
+        const auto error = max_tile_rmse(after, fresh.image());
+        const auto noise_error = max_tile_rmse(noise.image(), fresh.image());
+
+        std::cout << name << ": " << stats.tiles_rendered << '/' << stats.tile_count << " tiles rendered, "
+                  << (kept ? "kept tiles unchanged" : "kept tiles CHANGED") << ", max tile RMSE " << error
+                  << " (" << noise_error << " between fresh sessions)\n";
+
+        const auto flagged = static_cast<std::size_t>(std::ranges::count(stats.rendered, true));
+        const auto ok = kept && flagged == stats.tiles_rendered && error <= noise_tolerance * noise_error;
+        if (!ok) {
+            std::cout << "  FAILED\n";
+        }
+        return ok;
+    }
+
+private:
+    hittable_list<scalar> m_world;
+    camera<scalar> m_camera;
+    std::unique_ptr<render_session<scalar>> m_session;
+};
+} // namespace
+
+auto main() -> int
+{
+    rt::seed();
+    const auto world = random_spheres_scene<scalar>();
+
+    auto cam = random_spheres_camera<scalar>();
+    cam.image_width = 64;
+    cam.samples_per_pixel = 8;
+    cam.max_depth = 8;
+
+    auto c = checker{world, cam};
+    auto ok = true;
+
+    // Small spheres are added after the ground, and the three large ones last
+    const auto small_sphere = std::size_t{1};
+    const auto other_sphere = std::size_t{5};
+    const auto last = c.session().sphere_count() - 1;
+
+    {
+        const auto mat = std::make_shared<lambertian<scalar>>(color{0.9, 0.1, 0.1});
+        const auto &s = c.session().sphere_at(small_sphere);
+        c.set_sphere(small_sphere, s.m_center, s.m_radius, mat);
+        ok = c.check("Material", [&](auto &session) { return session.set_material(small_sphere, mat); }) && ok;
+    }
+    {
+        const auto &s = c.session().sphere_at(last);
+        const auto *old_mat = s.m_material.get();
+        const auto mat = std::make_shared<metal<scalar>>(color{0.9, 0.9, 0.2}, 0.3);
+        c.set_sphere(last, s.m_center, s.m_radius, mat);
+        ok = c.check("Replace", [&](auto &session) { return session.replace_material(old_mat, mat); }) && ok;
+    }
+    {
+        const auto &s = c.session().sphere_at(small_sphere);
+        const auto center = static_cast<coord<scalar>>(s.m_center + vec3<scalar>{0., 0.3, 0.5});
+        const auto radius = s.m_radius;
+        c.set_sphere(small_sphere, center, radius, s.m_material);
+        ok = c.check("Move", [&](auto &session) { return session.move_sphere(small_sphere, center, radius); }) && ok;
+    }
+    {
+        const auto mat = std::make_shared<diffuse_light<scalar>>(color{4., 4., 4.});
+        const auto &s = c.session().sphere_at(other_sphere);
+        c.set_sphere(other_sphere, s.m_center, s.m_radius, mat);
+        ok = c.check("Emissive", [&](auto &session) { return session.set_material(other_sphere, mat); }) && ok;
+    }
+
+    if (!ok) {
+        std::cout << "FAILED: an edit left the session image inconsistent with its scene\n";
+        return 1;
+    }
+}
\ No newline at end of file
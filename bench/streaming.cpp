@@ -0,0 +1,92 @@
+// Streams renders of two image sizes into PFM files with the same tile memory budget, and reports the peak
+// resident set size of each one, which should not grow with the image size. Also reports the size of the
+// framebuffer a non streaming render of the large image would need, for comparison.
+//
+//   rt_bench_streaming [tile budget in bytes] [small width] [large width]
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "image_sink.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+/// @return Value of a "<key>: <value> kB" line of /proc/self/status in bytes, or 0 if unknown
+auto status_bytes(const std::string &key) -> std::size_t
+{
+    auto status = std::ifstream{"/proc/self/status"};
+    auto line = std::string{};
+    while (std::getline(status, line)) {
+        if (line.starts_with(key + ':')) {
+            return std::stoull(line.substr(key.size() + 1)) * 1024;
+        }
+    }
+    return 0;
+}
+
+/// Resets the peak resident set size of the process to the current one
+/// @return false if the kernel does not allow it
+auto reset_peak_resident() -> bool
+{
+    auto clear_refs = std::ofstream{"/proc/self/clear_refs"};
+    clear_refs << "5";
+    clear_refs.flush();
+    return static_cast<bool>(clear_refs);
+}
+
+/// Streams the scene at the given width into a temporary file
+/// @return Peak resident set size during the render, in bytes
+auto stream(camera<scalar> cam, const int width, const hittable_list<scalar> &world, const hittable_list<scalar> &lights,
+            const std::size_t max_tile_bytes) -> std::size_t
+{
+    cam.image_width = width;
+    const auto path = std::filesystem::temp_directory_path() / ("rt_bench_streaming_" + std::to_string(width) + ".pfm");
+
+    if (!reset_peak_resident()) {
+        std::cout << "Cannot reset the peak resident set size, so it includes the previous renders\n";
+    }
+    {
+        auto out = std::ofstream{path, std::ios::binary};
+        auto sink = pfm_sink<scalar>{out};
+        cam.render_streaming(world, lights, sink, max_tile_bytes);
+    }
+    const auto peak = status_bytes("VmHWM");
+
+    std::filesystem::remove(path);
+    return peak;
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int
+{
+    const auto args = std::vector<std::string>(argv, argv + argc);
+    const auto max_tile_bytes = args.size() > 1 ? std::stoull(args[1]) : std::size_t{64 * 1024};
+    const auto small_width = args.size() > 2 ? std::stoi(args[2]) : 256;
+    const auto large_width = args.size() > 3 ? std::stoi(args[3]) : 2048;
+
+    const auto world = small_light_scene<scalar>();
+    const auto lights = world.lights();
+    auto cam = small_light_camera<scalar>();
+    cam.samples_per_pixel = 1;
+    cam.max_depth = 4;
+
+    std::cout << "Tile budget of " << max_tile_bytes << " bytes\n";
+    for (const auto width : {small_width, large_width}) {
+        const auto peak = stream(cam, width, world, lights, max_tile_bytes);
+        std::cout << width << " x " << width << ": peak resident set size " << peak / 1024 << " KiB\n";
+    }
+
+    const auto pixels = static_cast<std::size_t>(large_width) * static_cast<std::size_t>(large_width);
+    std::cout << "Framebuffer of a non streaming " << large_width << " x " << large_width << " render: "
+              << pixels * sizeof(pixel<scalar>) / 1024 << " KiB\n";
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+// Builds random sphere scenes of growing size in parallel, and reports for each size the build time,
+// the memory used per object and the render throughput, to find where each data structure stops scaling.
+// Memory is counted by the allocation hook of instrumentation.cpp, as the bytes requested while building.
+//
+//   rt_bench_stress [max object count] [thread count]
+
+#include <cmath>
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "instrumentation.hpp"
+#include "rtweekend.hpp"
+#include "scenes.hpp"
+
+using scalar = rt::scalar_type;
+
+namespace
+{
+constexpr auto seed = 42u;
+constexpr auto render_seconds = 1.;     // Time spent rendering at each size
+
+/// Renders the scene progressively for a fixed time, from outside of the cube holding its spheres. The view
+/// only covers the middle of the cube, so the rays of a partial pass are as costly as the ones of the others.
+/// @return Millions of camera rays per second, each one traced with all its bounces
+auto measure_mrays(const hittable_list<scalar> &world, const std::size_t count) -> double
+{
+    const auto half_side = std::cbrt(static_cast<scalar>(count)) / 2;
+
+    auto cam = camera<scalar>{};
+    cam.image_width = 32;
+    cam.samples_per_pixel = 1 << 16;
+    cam.max_depth = 10;
+    cam.vfov = 20.;
+    cam.lookfrom = coord{0., 0., 3. * half_side};
+    cam.lookat   = coord{0., 0., 0.};
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(render_seconds));
+    const auto image = cam.render_progressive(world, hittable_list<scalar>{}, deadline);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    auto rays = 0.;
+    for (auto j = 0; j < image.height(); ++j) {
+        for (auto i = 0; i < image.width(); ++i) {
+            rays += image.pixel_at(i, j).samples_per_pixel;
+        }
+    }
+    return rays / elapsed * 1e-6;
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int
+{
+    const auto args = std::vector<std::string>(argv, argv + argc);
+    const auto max_count = args.size() > 1 ? std::stoull(args[1]) : std::size_t{1'000'000};
+    const auto thread_count = args.size() > 2 ? static_cast<unsigned>(std::stoul(args[2])) : std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::cout << "Building with " << thread_count << " threads\n"
+              << std::setw(12) << "objects" << std::setw(14) << "build [s]" << std::setw(16) << "bytes/object"
+              << std::setw(12) << "Mrays/s" << '\n';
+
+    for (auto count = std::size_t{1'000}; count <= max_count; count *= 10) {
+        const auto bytes_before = rt::instrumentation::process_bytes_allocated().load();
+        const auto start = std::chrono::steady_clock::now();
+        const auto world = stress_scene<scalar>(count, seed, thread_count);
+        const auto build_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto bytes_after = rt::instrumentation::process_bytes_allocated().load();
+
+        // Includes the shared material palette and the thread states, which are negligible at large sizes
+        const auto bytes_per_object = static_cast<double>(bytes_after - bytes_before) / static_cast<double>(count);
+
+        std::cout << std::setw(12) << count << std::setw(14) << build_seconds << std::setw(16) << bytes_per_object
+                  << std::setw(12) << measure_mrays(world, count) << std::endl;
+    }
+}
\ No newline at end of file
@@ -2,11 +2,35 @@
 
 #include <cmath>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <stop_token>
+
 #include "color.hpp"
+#include "framebuffer.hpp"
 #include "hittable.hpp"
+#include "hittable_list.hpp"
+#include "image_sink.hpp"
+#include "radiance_cache.hpp"
 #include "random.hpp"
+#include "rtweekend.hpp"
 #include "vec3.hpp"
 
+/// Receives every ray segment traced while rendering, e.g. to track what each pixel depends on
+template <typename T>
+class path_observer
+{
+public:
+    virtual ~path_observer() = default;
+
+    /// @param t_end Ray parameter where the segment ends, infinity if it escaped the scene
+    /// @param object Primitive hit at the end of the segment, nullptr if it escaped the scene
+    virtual auto on_segment(const ray<T> &r, T t_end, const hittable<T> *object) -> void = 0;
+};
+
 template <typename T>
 class camera
 {
@@ -24,25 +48,129 @@ public:
     double defocus_angle = 0.;  // Variation angle of rays through each pixel
     double focus_dist = 10.;    // Distance from camera lookfrom point to plane of perfect focus
 
+    std::optional<color<T>> background{};  // Constant background radiance, sky gradient if unset
+    radiance_cache<T> *indirect_cache = nullptr;    // If set, used for diffuse bounces after the first one
+
     auto render(const hittable<T> &world) -> void 
     {
-        initialize();
+        render(world, hittable_list<T>{});
+    }
 
-        std::cout << "P3\n" << image_width << ' ' << m_image_height << "\n255\n";    
+    /// Renders the image into std::cout, sampling the given lights explicitly at diffuse hits
+    auto render(const hittable<T> &world, const hittable_list<T> &lights) -> void 
+    {
+        initialize();
 
+        auto image = framebuffer<T>{image_width, m_image_height};
         for (auto j = 0; j < m_image_height; ++j) {        
             std::clog << "\rScanlines remaining: " << (m_image_height - j) << ' ' << std::flush;
-            
-            for (auto i = 0; i < image_width; ++i) {
-                auto pixel_color = color{0., 0., 0.};
+            render_scanline(j, samples_per_pixel, world, lights, image);
+        }
+        image.write_ppm(std::cout);
+
+        std::clog << "\rDone.                 \n";
+    }
+
+    /// Renders the image into a framebuffer, without any output
+    auto render_image(const hittable<T> &world, const hittable_list<T> &lights) -> framebuffer<T>
+    {
+        initialize();
+
+        auto image = framebuffer<T>{image_width, m_image_height};
+        for (auto j = 0; j < m_image_height; ++j) {        
+            render_scanline(j, samples_per_pixel, world, lights, image);
+        }
+        return image;
+    }
+
+    /// Renders the image in whole-image passes, each one doubling the sample count of the previous ones, up to
+    /// samples_per_pixel. The deadline and the stop token are checked before each pixel, so late passes, which
+    /// take many samples per pixel, overrun the deadline by one pixel at most. Rendering stops as soon as
+    /// either is reached, possibly in the middle of a scanline.
+    /// @param on_pass Called with the image after each completed pass
+    /// @return Image rendered so far, with the sample count of each pixel
+    auto render_progressive(const hittable<T> &world, const hittable_list<T> &lights,
+                            const std::chrono::steady_clock::time_point deadline, const std::stop_token stop = {},
+                            const std::function<void(const framebuffer<T> &)> &on_pass = {}) -> framebuffer<T>
+    {
+        initialize();
+
+        const auto out_of_time = [&] {
+            return stop.stop_requested() || std::chrono::steady_clock::now() >= deadline;
+        };
+
+        auto image = framebuffer<T>{image_width, m_image_height};
+        for (auto samples_done = 0; samples_done < samples_per_pixel; ) {
+            const auto pass_samples = std::min(std::max(samples_done, 1), samples_per_pixel - samples_done);
+            for (auto j = 0; j < m_image_height; ++j) {
+                for (auto i = 0; i < image_width; ++i) {
+                    if (out_of_time()) {
+                        return image;
+                    }
+                    for (auto sample = 0; sample < pass_samples; ++sample) {
+                        image.add_sample(i, j, sample_pixel(i, j, world, lights));
+                    }
+                }
+            }
 
+            samples_done += pass_samples;
+            if (on_pass) {
+                on_pass(image);
+            }
+        }
+        return image;
+    }
+
+    /// Renders the image region covered by tile, whose upper left pixel is at x0,y0
+    /// @param observer If not null, receives every ray segment traced for the tile
+    auto render_tile(const int x0, const int y0, const hittable<T> &world, const hittable_list<T> &lights,
+                     framebuffer<T> &tile, path_observer<T> *observer = nullptr) -> void
+    {
+        initialize();
+
+        m_observer = observer;
+        for (auto j = 0; j < tile.height(); ++j) {
+            for (auto i = 0; i < tile.width(); ++i) {
                 for (auto sample = 0; sample < samples_per_pixel; ++sample) {
-                    const auto r = get_ray(i, j);
-                    pixel_color += ray_color(std::move(r), max_depth, world);
+                    tile.add_sample(i, j, sample_pixel(x0 + i, y0 + j, world, lights));
                 }
-                std::cout << pixel{pixel_color, samples_per_pixel};
             }
         }
+        m_observer = nullptr;
+    }
+
+    /// @return Height of the rendered image, derived from its width and aspect ratio
+    auto image_height() -> int
+    {
+        initialize();
+        return m_image_height;
+    }
+
+    /// Renders the image in bands of tiles, in scanline order, writing each tile to the sink as soon as it is
+    /// finished. Only one tile is accumulated at a time, sized to use at most max_tile_bytes unless a single
+    /// pixel does not fit, so peak memory does not depend on the image size.
+    auto render_streaming(const hittable<T> &world, const hittable_list<T> &lights, image_sink<T> &sink,
+                          const std::size_t max_tile_bytes) -> void
+    {
+        initialize();
+
+        // Prefer tiles spanning whole rows, so sinks receive the image sequentially
+        const auto max_pixels = std::max<std::size_t>(max_tile_bytes / sizeof(pixel<T>), 1);
+        const auto width = static_cast<std::size_t>(image_width);
+        const auto tile_width = static_cast<int>(std::min(width, max_pixels));
+        const auto tile_height = static_cast<int>(std::clamp<std::size_t>(max_pixels / width, 1, static_cast<std::size_t>(m_image_height)));
+
+        sink.begin(image_width, m_image_height);
+        for (auto y0 = 0; y0 < m_image_height; y0 += tile_height) {
+            std::clog << "\rScanlines remaining: " << (m_image_height - y0) << ' ' << std::flush;
+
+            for (auto x0 = 0; x0 < image_width; x0 += tile_width) {
+                auto tile = framebuffer<T>{std::min(tile_width, image_width - x0), std::min(tile_height, m_image_height - y0)};
+                render_tile(x0, y0, world, lights, tile);
+                sink.write_tile(x0, y0, tile);
+            }
+        }
+        sink.end();
 
         std::clog << "\rDone.                 \n";
     }
@@ -56,6 +184,7 @@ private:
     vec3<T> m_u, m_v, m_w;      // Camera frame basis vectors
     vec3<T> m_defocus_disk_u;   // Defocus disk horizontal radius
     vec3<T> m_defocus_disk_v;   // Defocus disk vertical radius
+    path_observer<T> *m_observer{nullptr};  // Receives the traced segments, if set
     
     auto initialize() -> void 
     {
@@ -97,6 +226,21 @@ private:
         m_defocus_disk_v = m_v * defocus_radius;
     }
 
+    auto render_scanline(const int j, const int samples, const hittable<T> &world, const hittable_list<T> &lights, framebuffer<T> &image) -> void
+    {
+        for (auto i = 0; i < image_width; ++i) {
+            for (auto sample = 0; sample < samples; ++sample) {
+                image.add_sample(i, j, sample_pixel(i, j, world, lights));
+            }
+        }
+    }
+
+    /// @return Radiance of one random camera ray through pixel i,j
+    auto sample_pixel(const int i, const int j, const hittable<T> &world, const hittable_list<T> &lights) -> color<T>
+    {
+        return ray_color(get_ray(i, j), max_depth, world, lights, 0);
+    }
+
     auto get_ray(const int i, const int j) -> ray<T>
     {
         // Get a randomly sampled camera ray for the pixel at location i,j, originating from the
@@ -124,24 +268,105 @@ private:
         return static_cast<coord<T>>(m_center + (p.x() * m_defocus_disk_u) + (p.y() * m_defocus_disk_v));
     }
 
-    auto ray_color(ray<T> r, const int depth, const hittable<T> &world) const -> color<T> 
+    /// @param bsdf_pdf Density with which the previous bounce sampled r, or 0 if it cannot be
+    ///        combined with light sampling (camera rays and specular bounces)
+    auto ray_color(const ray<T> &r, const int depth, const hittable<T> &world, const hittable_list<T> &lights, const T bsdf_pdf) const -> color<T> 
     {
         // If we've exceeded the ray bounce limit, no more light is gathered
         if (depth <= 0) {
             return {};
         }
 
-        const auto unit_direction = r.direction.unit_vector();
+        const auto rec = world.hit(r, {rt::surface_epsilon, rt::infinity});
+        observe(r, rec ? rec->t : rt::infinity, rec ? rec->object : nullptr);
+        if (!rec) {
+            return background_color(r);
+        }
+
+        // Emission found by BSDF sampling was also reachable through light sampling at the previous bounce
+        vec3<T> radiance = rec->mat->emitted();
+        if (bsdf_pdf > 0 && !lights.objects.empty() && rec->mat->is_emissive()) {
+            radiance *= power_heuristic(bsdf_pdf, lights.pdf_value(r.origin, r.direction));
+        }
 
-        constexpr auto surface_epsilon = 0.001; // Start ray slightly above the surface, to avoid rounding errors
-        if (const auto rec = world.hit(r, {surface_epsilon, rt::infinity})) {
-            if (auto scatter_result = rec->mat->scatter(r, *rec)) {
-                return static_cast<color<T>>(scatter_result->attenuation * ray_color(scatter_result->scattered, depth - 1, world));
+        // Diffuse surfaces reached after a bounce may use the light cached around them, which does not
+        // depend on their albedo so surfaces of any color can share it
+        const auto albedo = indirect_cache && depth < max_depth ? rec->mat->diffuse_albedo() : std::nullopt;
+        if (albedo) {
+            if (const auto cached = indirect_cache->lookup(rec->pos, rec->normal)) {
+                return static_cast<color<T>>(radiance + *albedo * *cached);
             }
+        }
+
+        const auto scatter_result = rec->mat->scatter(r, *rec);
+        if (!scatter_result) {
+            return static_cast<color<T>>(radiance);
+        }
+
+        // Light reaching the surface, to be weighted by the attenuation
+        const auto scattering_pdf = rec->mat->scattering_pdf(r, *rec, scatter_result->scattered);
+        auto incident = vec3<T>{};
+        if (!lights.objects.empty()) {
+            incident += sample_lights(r, *rec, world, lights);
+        }
+        incident += ray_color(scatter_result->scattered, depth - 1, world, lights, scattering_pdf);
+
+        if (albedo) {
+            indirect_cache->add(rec->pos, rec->normal, static_cast<color<T>>(incident));
+        }
+        return static_cast<color<T>>(radiance + scatter_result->attenuation * incident);
+    } 
+
+    /// Next event estimation: direct light through a shadow ray towards a randomly chosen light,
+    /// weighted against BSDF sampling by multiple importance sampling
+    /// @return Light reaching the surface, to be weighted by the attenuation of its material
+    auto sample_lights(const ray<T> &r, const hit_record<T> &rec, const hittable<T> &world,
+                       const hittable_list<T> &lights) const -> color<T>
+    {
+        const auto light_ray = ray<T>{rec.pos, lights.random(rec.pos)};
+
+        const auto scattering_pdf = rec.mat->scattering_pdf(r, rec, light_ray);
+        if (scattering_pdf <= 0) {
+            return {};
+        }
+        const auto light_pdf = lights.pdf_value(light_ray.origin, light_ray.direction);
+        if (light_pdf <= 0) {
+            return {};
+        }
+
+        // The shadow ray may hit an occluder, or any other light of the list
+        // Only the object hit matters, so no surface data is computed
+        const auto light_hit = world.closest_hit(light_ray, {rt::surface_epsilon, rt::infinity});
+        observe(light_ray, light_hit ? light_hit->t : rt::infinity, light_hit ? light_hit->object : nullptr);
+        if (!light_hit || !light_hit->object->is_emissive()) {
             return {};
         }
 
+        // BSDF * cosine equals attenuation * scattering_pdf for materials with a scattering pdf
+        const auto weight = scattering_pdf * power_heuristic(light_pdf, scattering_pdf) / light_pdf;
+        return static_cast<color<T>>(weight * light_hit->object->emitted());
+    }
+
+    auto observe(const ray<T> &r, const T t_end, const hittable<T> *object) const -> void
+    {
+        if (m_observer) {
+            m_observer->on_segment(r, t_end, object);
+        }
+    }
+
+    auto background_color(const ray<T> &r) const -> color<T>
+    {
+        if (background) {
+            return *background;
+        }
+
+        const auto unit_direction = r.direction.unit_vector();
         const auto a = (unit_direction.y() + 1.0) * 0.5;
         return static_cast<color<T>>((1.0 - a) * color{1.0, 1.0, 1.0} + a * color{0.5, 0.7, 1.0});
-    } 
+    }
+
+    static auto power_heuristic(const T pdf, const T other_pdf) -> T
+    {
+        return pdf * pdf / (pdf * pdf + other_pdf * other_pdf);
+    }
 };
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <cmath>
 
+#include <array>
 #include <iostream>
 
 #include "interval.hpp"
@@ -12,7 +13,7 @@ class color : public vec3<T>
 {
 public:
     color() = default;
-    color(std::initializer_list<T> l) : vec3<T>{l} {}
+    color(const T r, const T g, const T b) : vec3<T>{r, g, b} {}
     explicit color(vec3<T> v) : vec3<T>{std::move(v)} {};
 
     auto r() const -> T 
@@ -53,10 +54,14 @@ struct pixel
     int samples_per_pixel; 
 };
 
+/// @return Color of the pixel as [0,255] values in gamma space
 template <typename T>
-inline auto operator<<(std::ostream &t_out, const pixel<T> t_pixel) -> std::ostream &
+inline auto to_rgb8(const pixel<T> t_pixel) -> std::array<int, 3>
 {
     // Divide the color by the number of samples
+    if (t_pixel.samples_per_pixel <= 0) {
+        return {0, 0, 0};
+    }
     const auto norm_color = static_cast<color<T>>(t_pixel.pixel_color / static_cast<T>(t_pixel.samples_per_pixel));
 
     // Transform color from linear to gamma space
@@ -65,11 +70,17 @@ inline auto operator<<(std::ostream &t_out, const pixel<T> t_pixel) -> std::ostr
     };
     const auto gamma_color = linear_to_gamma(norm_color);
 
-    // Write the translated [0,255] value of each color component.
+    // Translate to the [0,255] value of each color component.
     constexpr auto intensity = interval<T>{0.000, 0.999};
-    t_out 
-        << static_cast<int>(256 * intensity.clamp(gamma_color.r())) << ' '
-        << static_cast<int>(256 * intensity.clamp(gamma_color.g())) << ' '
-        << static_cast<int>(256 * intensity.clamp(gamma_color.b())) << '\n';
+    return {static_cast<int>(256 * intensity.clamp(gamma_color.r())),
+            static_cast<int>(256 * intensity.clamp(gamma_color.g())),
+            static_cast<int>(256 * intensity.clamp(gamma_color.b()))};
+}
+
+template <typename T>
+inline auto operator<<(std::ostream &t_out, const pixel<T> t_pixel) -> std::ostream &
+{
+    const auto rgb = to_rgb8(t_pixel);
+    t_out << rgb[0] << ' ' << rgb[1] << ' ' << rgb[2] << '\n';
     return t_out;
 }
\ No newline at end of file
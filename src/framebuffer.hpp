@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cmath>
+
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "color.hpp"
+
+/// Accumulation buffer holding the sum of the radiance samples taken for each pixel
+template<typename T>
+class framebuffer
+{
+public:
+    framebuffer(const int t_width, const int t_height)
+        : m_width{t_width}, m_height{t_height}
+    {
+        if (m_width < 1 || m_height < 1) {
+            throw std::invalid_argument{"Invalid framebuffer size"};
+        }
+        m_pixels.resize(static_cast<std::size_t>(m_width) * static_cast<std::size_t>(m_height));
+    }
+
+    auto width() const -> int
+    {
+        return m_width;
+    }
+
+    auto height() const -> int
+    {
+        return m_height;
+    }
+
+    auto add_sample(const int i, const int j, const color<T> sample) -> void
+    {
+        auto &p = at(i, j);
+        p.pixel_color += sample;
+        ++p.samples_per_pixel;
+    }
+
+    /// Replaces the pixels of the region covered by tile, whose upper left pixel is at x0,y0
+    auto paste(const int x0, const int y0, const framebuffer &tile) -> void
+    {
+        if (x0 < 0 || y0 < 0 || x0 + tile.width() > m_width || y0 + tile.height() > m_height) {
+            throw std::out_of_range{"Tile outside of the image"};
+        }
+        for (auto j = 0; j < tile.height(); ++j) {
+            for (auto i = 0; i < tile.width(); ++i) {
+                at(x0 + i, y0 + j) = tile.pixel_at(i, j);
+            }
+        }
+    }
+
+    /// @return Accumulated color and sample count of pixel i,j
+    auto pixel_at(const int i, const int j) const -> pixel<T>
+    {
+        return m_pixels[index(i, j)];
+    }
+
+    /// @return Mean linear radiance of pixel i,j
+    auto value(const int i, const int j) const -> color<T>
+    {
+        const auto &p = m_pixels[index(i, j)];
+        return p.samples_per_pixel > 0
+                ? static_cast<color<T>>(p.pixel_color / static_cast<T>(p.samples_per_pixel))
+                : color<T>{};
+    }
+
+    /// Writes the image as a plain PPM file, in gamma space
+    auto write_ppm(std::ostream &out) const -> void
+    {
+        out << "P3\n" << m_width << ' ' << m_height << "\n255\n";
+        for (const auto &p : m_pixels) {
+            out << p;
+        }
+    }
+
+    /// Writes the mean linear radiance as a little endian PFM file, rows stored bottom to top
+    auto write_pfm(std::ostream &out) const -> void
+    {
+        out << "PF\n" << m_width << ' ' << m_height << "\n-1.0\n";
+        for (auto j = m_height - 1; j >= 0; --j) {
+            for (auto i = 0; i < m_width; ++i) {
+                const auto v = value(i, j);
+                const auto rgb = std::array{static_cast<float>(v.r()), static_cast<float>(v.g()), static_cast<float>(v.b())};
+                out.write(reinterpret_cast<const char *>(rgb.data()), sizeof(rgb));
+            }
+        }
+    }
+
+    /// Reads a little endian PFM file, as written by write_pfm(), with one sample per pixel
+    static auto read_pfm(std::istream &in) -> framebuffer
+    {
+        auto magic = std::string{};
+        auto width = 0;
+        auto height = 0;
+        auto scale = 0.;
+        in >> magic >> width >> height >> scale;
+        in.get();
+        if (!in || magic != "PF" || scale >= 0.) {
+            throw std::runtime_error{"Unsupported PFM file"};
+        }
+
+        auto image = framebuffer{width, height};
+        for (auto j = height - 1; j >= 0; --j) {
+            for (auto i = 0; i < width; ++i) {
+                auto rgb = std::array<float, 3>{};
+                in.read(reinterpret_cast<char *>(rgb.data()), sizeof(rgb));
+                image.add_sample(i, j, color<T>{rgb[0], rgb[1], rgb[2]});
+            }
+        }
+        if (!in) {
+            throw std::runtime_error{"Truncated PFM file"};
+        }
+        return image;
+    }
+
+private:
+    int m_width;
+    int m_height;
+    std::vector<pixel<T>> m_pixels;
+
+    auto index(const int i, const int j) const -> std::size_t
+    {
+        return static_cast<std::size_t>(j) * static_cast<std::size_t>(m_width) + static_cast<std::size_t>(i);
+    }
+
+    auto at(const int i, const int j) -> pixel<T> &
+    {
+        return m_pixels[index(i, j)];
+    }
+};
+
+template<typename T>
+inline auto check_same_size(const framebuffer<T> &image, const framebuffer<T> &reference) -> void
+{
+    if (image.width() != reference.width() || image.height() != reference.height()) {
+        throw std::invalid_argument{"Image sizes differ"};
+    }
+}
+
+/// @return Root mean squared error between the mean linear radiance of two images of the same size
+template<typename T>
+inline auto rmse(const framebuffer<T> &image, const framebuffer<T> &reference) -> T
+{
+    check_same_size(image, reference);
+
+    auto sum = T{};
+    for (auto j = 0; j < image.height(); ++j) {
+        for (auto i = 0; i < image.width(); ++i) {
+            sum += (image.value(i, j) - reference.value(i, j)).length_squared();
+        }
+    }
+    return std::sqrt(sum / (3 * static_cast<T>(image.width()) * static_cast<T>(image.height())));
+}
+
+/// @return Relative mean squared error, where each squared error is divided by the squared reference
+///         value plus a small epsilon, so dark and bright regions weigh alike
+template<typename T>
+inline auto relmse(const framebuffer<T> &image, const framebuffer<T> &reference, const T epsilon = 0.01) -> T
+{
+    check_same_size(image, reference);
+
+    auto sum = T{};
+    for (auto j = 0; j < image.height(); ++j) {
+        for (auto i = 0; i < image.width(); ++i) {
+            const auto v = image.value(i, j);
+            const auto ref = reference.value(i, j);
+            for (auto c = 0u; c < 3; ++c) {
+                sum += (v[c] - ref[c]) * (v[c] - ref[c]) / (ref[c] * ref[c] + epsilon);
+            }
+        }
+    }
+    return sum / (3 * static_cast<T>(image.width()) * static_cast<T>(image.height()));
+}
\ No newline at end of file
@@ -12,20 +12,29 @@
 template<typename T>
 class material;
 
+template <typename T>
+class hittable;
+
 template <typename T>
 struct hit_record
 {
-    using material_type = std::shared_ptr<material<T>>;
+    using material_type = const material<T> *; // Non-owning, the scene keeps the materials alive
 
     T t;
     coord<T> pos;
     bool front_face;
     vec3<T> normal;
     material_type mat;
+    const hittable<T> *object{nullptr};     // Primitive hit, set by hittable::hit()
 
     /// @param t_outward_normal Unit length vector at the hit position facing outwards
-    hit_record(const ray<T> t_r, const T t_t, const vec3<T> t_outward_normal, material_type t_mat) 
-        : t{t_t}, pos{t_r.at(t_t)}, front_face{dot(t_r.direction, t_outward_normal) < 0.0},
+    hit_record(const ray<T> &t_r, const T t_t, const vec3<T> &t_outward_normal, const material_type t_mat) 
+        : hit_record{t_r, t_t, t_r.at(t_t), t_outward_normal, t_mat} {};
+
+    /// @param t_pos Hit position, when already computed by the caller
+    /// @param t_outward_normal Unit length vector at the hit position facing outwards
+    hit_record(const ray<T> &t_r, const T t_t, const coord<T> &t_pos, const vec3<T> &t_outward_normal, const material_type t_mat) 
+        : t{t_t}, pos{t_pos}, front_face{dot(t_r.direction, t_outward_normal) < 0.0},
           normal{front_face ? t_outward_normal : -t_outward_normal}, mat{t_mat} {
             if (!mat) {
                 throw std::invalid_argument{"Invalid material"};
@@ -33,10 +42,63 @@ struct hit_record
         };
 };
 
+/// Result of a distance-only intersection query: the closest ray parameter and the primitive
+/// that produced it. No surface data is computed until the candidate is finalized.
+template <typename T>
+struct hit_candidate
+{
+    T t;
+    const hittable<T> *object;
+};
+
 template <typename T>
 class hittable
 {
 public:
     virtual ~hittable() = default;
-    virtual auto hit(ray<T> t_r, interval<T> ray_t) const -> std::optional<hit_record<T>> = 0;
+
+    /// Finds the closest intersection within ray_t without computing any surface data
+    virtual auto closest_hit(const ray<T> &t_r, interval<T> ray_t) const -> std::optional<hit_candidate<T>> = 0;
+
+    /// Computes the full hit record for a candidate previously returned by closest_hit
+    virtual auto finalize(const ray<T> &t_r, hit_candidate<T> t_candidate) const -> hit_record<T> = 0;
+
+    /// @return true if anything is hit within ray_t. Stops at the first intersection found,
+    ///         so it is suitable for occlusion (shadow) queries
+    virtual auto any_hit(const ray<T> &t_r, interval<T> ray_t) const -> bool = 0;
+
+    /// @return Solid angle density with which random() picks t_direction from t_origin
+    virtual auto pdf_value(const coord<T> &, const vec3<T> &) const -> T
+    {
+        return 0;
+    }
+
+    /// @return Random direction from t_origin towards the object, used for explicit light sampling
+    virtual auto random(const coord<T> &) const -> vec3<T>
+    {
+        return {1., 0., 0.};
+    }
+
+    /// @return true if the object emits light
+    virtual auto is_emissive() const -> bool
+    {
+        return false;
+    }
+
+    /// @return Radiance emitted by the object, so shadow rays can read it without finalizing their hit
+    virtual auto emitted() const -> color<T>
+    {
+        return {};
+    }
+
+    /// Closest intersection with full surface data, computed only for the winning primitive
+    auto hit(const ray<T> &t_r, const interval<T> ray_t) const -> std::optional<hit_record<T>>
+    {
+        if (const auto candidate = closest_hit(t_r, ray_t)) {
+            auto rec = candidate->object->finalize(t_r, *candidate);
+            rec.object = candidate->object;
+            return rec;
+        }
+        return std::nullopt;
+    }
 };
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <initializer_list>
 #include <memory>
 #include <utility>
 #include <vector>
 
 #include "hittable.hpp"
+#include "random.hpp"
 
 template<typename T>
 class hittable_list : public hittable<T>
@@ -18,8 +20,8 @@ public:
 
     explicit hittable_list(const std::initializer_list<object_type> list) 
     {
-        for (const auto obj: list) {
-            add(std::move(obj));
+        for (const auto &obj: list) {
+            add(obj);
         }
     }
 
@@ -28,19 +30,64 @@ public:
         objects.emplace_back(std::move(obj));
     }
 
-    auto hit(const ray<T> r, const interval<T> ray_t) const -> std::optional<hit_record<T>> override
+    auto closest_hit(const ray<T> &r, const interval<T> ray_t) const -> std::optional<hit_candidate<T>> override
     {
-        auto closest_so_far = ray_t.max;
-        auto rec = std::optional<hit_record<T>>{};
+        auto closest = std::optional<hit_candidate<T>>{};
 
         for (const auto &obj : objects) {
-            if (auto rec_found = obj->hit(r, {ray_t.min, closest_so_far})) {
-                rec = std::move(rec_found);
-                closest_so_far = rec->t;            
+            if (const auto candidate = obj->closest_hit(r, {ray_t.min, closest ? closest->t : ray_t.max})) {
+                closest = candidate;
             }
         }
 
-        return rec;
+        return closest;
     }
 
+    auto finalize(const ray<T> &r, const hit_candidate<T> candidate) const -> hit_record<T> override
+    {
+        // Candidates always refer to the primitive that produced them, never to the list itself
+        return candidate.object->finalize(r, candidate);
+    }
+
+    auto any_hit(const ray<T> &r, const interval<T> ray_t) const -> bool override
+    {
+        return std::ranges::any_of(objects, [&](const auto &obj) { return obj->any_hit(r, ray_t); });
+    }
+
+    auto pdf_value(const coord<T> &origin, const vec3<T> &direction) const -> T override
+    {
+        // Objects are picked uniformly by random(), so the density is the average of theirs
+        if (objects.empty()) {
+            return 0;
+        }
+
+        auto sum = T{};
+        for (const auto &obj : objects) {
+            sum += obj->pdf_value(origin, direction);
+        }
+        return sum / static_cast<T>(objects.size());
+    }
+
+    auto random(const coord<T> &origin) const -> vec3<T> override
+    {
+        const auto index = static_cast<std::size_t>(rt::random_t<T>(0., static_cast<T>(objects.size())));
+        return objects[std::min(index, objects.size() - 1)]->random(origin);
+    }
+
+    auto is_emissive() const -> bool override
+    {
+        return std::ranges::any_of(objects, [](const auto &obj) { return obj->is_emissive(); });
+    }
+
+    /// @return List with the emissive objects, to be used for explicit light sampling
+    auto lights() const -> hittable_list
+    {
+        auto light_list = hittable_list{};
+        for (const auto &obj : objects) {
+            if (obj->is_emissive()) {
+                light_list.add(obj);
+            }
+        }
+        return light_list;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+#include "color.hpp"
+#include "framebuffer.hpp"
+
+/// Destination of an image rendered in tiles, which are written as soon as they are finished so the
+/// whole image never needs to be held in memory
+template<typename T>
+class image_sink
+{
+public:
+    virtual ~image_sink() = default;
+
+    /// Called once before any tile is written
+    virtual auto begin(int width, int height) -> void = 0;
+
+    /// Writes a finished tile whose upper left pixel is at x0,y0 of the image
+    virtual auto write_tile(int x0, int y0, const framebuffer<T> &tile) -> void = 0;
+
+    /// Called once after all the tiles have been written
+    virtual auto end() -> void {}
+};
+
+/// Fixed size pixel records after a header, so that any tile can be written in place by seeking.
+/// The stream must be seekable (e.g. a file) unless tiles span whole rows and arrive in order.
+template<typename T>
+class raster_sink : public image_sink<T>
+{
+public:
+    explicit raster_sink(std::ostream &t_out) : m_out{t_out} {}
+
+    auto begin(const int width, const int height) -> void override
+    {
+        m_width = width;
+        m_height = height;
+        write_header(m_out, width, height);
+        m_data_start = m_out.tellp();
+        m_next_record = 0;
+    }
+
+    auto write_tile(const int x0, const int y0, const framebuffer<T> &tile) -> void override
+    {
+        if (x0 < 0 || y0 < 0 || x0 + tile.width() > m_width || y0 + tile.height() > m_height) {
+            throw std::out_of_range{"Tile outside of the image"};
+        }
+
+        const auto record_size = static_cast<std::streamoff>(pixel_size());
+        auto row = std::vector<char>(static_cast<std::size_t>(tile.width()) * pixel_size());
+        for (auto j = 0; j < tile.height(); ++j) {
+            for (auto i = 0; i < tile.width(); ++i) {
+                encode_pixel(tile.pixel_at(i, j), row.data() + static_cast<std::size_t>(i) * pixel_size());
+            }
+
+            // Only seek when needed, so sequential writes also work on streams that cannot seek
+            const auto record = static_cast<std::streamoff>(file_row(y0 + j)) * m_width + x0;
+            if (record != m_next_record) {
+                m_out.seekp(m_data_start + record_size * record);
+            }
+            m_out.write(row.data(), static_cast<std::streamsize>(row.size()));
+            m_next_record = record + tile.width();
+        }
+
+        if (!m_out) {
+            throw std::runtime_error{"Failed to write image tile"};
+        }
+    }
+
+    auto end() -> void override
+    {
+        m_out.flush();
+    }
+
+protected:
+    virtual auto write_header(std::ostream &out, int width, int height) const -> void = 0;
+    virtual auto pixel_size() const -> std::size_t = 0;
+    virtual auto encode_pixel(pixel<T> p, char *dest) const -> void = 0;
+
+    /// @return Row of the file where image row j is stored
+    virtual auto file_row(const int j) const -> int
+    {
+        return j;
+    }
+
+    auto height() const -> int
+    {
+        return m_height;
+    }
+
+private:
+    std::ostream &m_out;
+    int m_width{0};
+    int m_height{0};
+    std::streampos m_data_start{};
+    std::streamoff m_next_record{0};    // Record following the last one written
+};
+
+/// Binary (P6) PPM, 8 bits per channel in gamma space
+template<typename T>
+class ppm_sink : public raster_sink<T>
+{
+public:
+    using raster_sink<T>::raster_sink;
+
+protected:
+    auto write_header(std::ostream &out, const int width, const int height) const -> void override
+    {
+        out << "P6\n" << width << ' ' << height << "\n255\n";
+    }
+
+    auto pixel_size() const -> std::size_t override
+    {
+        return 3;
+    }
+
+    auto encode_pixel(const pixel<T> p, char *dest) const -> void override
+    {
+        const auto rgb = to_rgb8(p);
+        for (auto c = 0u; c < 3; ++c) {
+            dest[c] = static_cast<char>(static_cast<std::uint8_t>(rgb[c]));
+        }
+    }
+};
+
+/// Little endian PFM with the mean linear radiance of each pixel. Rows are stored bottom to top, so the
+/// stream must be a file that can seek past its current end.
+template<typename T>
+class pfm_sink : public raster_sink<T>
+{
+public:
+    using raster_sink<T>::raster_sink;
+
+protected:
+    auto write_header(std::ostream &out, const int width, const int height) const -> void override
+    {
+        out << "PF\n" << width << ' ' << height << "\n-1.0\n";
+    }
+
+    auto pixel_size() const -> std::size_t override
+    {
+        return sizeof(std::array<float, 3>);
+    }
+
+    auto encode_pixel(const pixel<T> p, char *dest) const -> void override
+    {
+        const auto v = p.samples_per_pixel > 0
+                ? static_cast<color<T>>(p.pixel_color / static_cast<T>(p.samples_per_pixel))
+                : color<T>{};
+        const auto rgb = std::array{static_cast<float>(v.r()), static_cast<float>(v.g()), static_cast<float>(v.b())};
+        std::copy_n(reinterpret_cast<const char *>(rgb.data()), sizeof(rgb), dest);
+    }
+
+    auto file_row(const int j) const -> int override
+    {
+        return raster_sink<T>::height() - 1 - j;
+    }
+};
\ No newline at end of file
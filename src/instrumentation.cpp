@@ -0,0 +1,49 @@
+// Replacement of the global allocation functions, counting every allocation made by the calling thread.
+// Only meant to be linked into instrumented executables.
+
+#include <cstdlib>
+#include <new>
+
+#include "instrumentation.hpp"
+
+namespace
+{
+auto allocate(const std::size_t size) -> void *
+{
+    rt::instrumentation::count_allocation(size);
+    if (auto *p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+} // namespace
+
+auto operator new(const std::size_t size) -> void *
+{
+    return allocate(size);
+}
+
+auto operator new[](const std::size_t size) -> void *
+{
+    return allocate(size);
+}
+
+auto operator delete(void *p) noexcept -> void
+{
+    std::free(p);
+}
+
+auto operator delete[](void *p) noexcept -> void
+{
+    std::free(p);
+}
+
+auto operator delete(void *p, std::size_t) noexcept -> void
+{
+    std::free(p);
+}
+
+auto operator delete[](void *p, std::size_t) noexcept -> void
+{
+    std::free(p);
+}
\ No newline at end of file
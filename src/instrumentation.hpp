@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/// Counters for the hot path instrumentation. Heap allocations are only counted in executables that link
+/// instrumentation.cpp, which replaces the global operator new, and vec3 copies only in translation units
+/// compiled with RT_INSTRUMENT defined.
+namespace rt::instrumentation
+{
+struct counters
+{
+    std::uint64_t allocations{0};       // Calls to operator new
+    std::uint64_t bytes_allocated{0};   // Bytes requested from operator new
+    std::uint64_t bytes_copied{0};      // Bytes of vector data copied
+};
+
+/// @return Counters of the calling thread
+inline auto thread_counters() -> counters &
+{
+    thread_local auto c = counters{};
+    return c;
+}
+
+/// @return Bytes requested from operator new by all the threads of the process, e.g. to measure data
+///         structures built in parallel
+inline auto process_bytes_allocated() -> std::atomic<std::uint64_t> &
+{
+    static auto bytes = std::atomic<std::uint64_t>{0};
+    return bytes;
+}
+
+inline auto count_allocation(const std::size_t bytes) -> void
+{
+    auto &c = thread_counters();
+    ++c.allocations;
+    c.bytes_allocated += bytes;
+    process_bytes_allocated().fetch_add(bytes, std::memory_order_relaxed);
+}
+
+inline auto count_copy(const std::size_t bytes) -> void
+{
+    thread_counters().bytes_copied += bytes;
+}
+} // namespace rt::instrumentation
\ No newline at end of file
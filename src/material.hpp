@@ -20,7 +20,35 @@ class material
 {
 public:
     virtual ~material() = default;
-    virtual auto scatter(ray<T> r_in, hit_record<T> rec) -> std::optional<scatter_result<T>> const = 0;
+    virtual auto scatter(const ray<T> &r_in, const hit_record<T> &rec) const -> std::optional<scatter_result<T>> = 0;
+
+    /// @return Radiance emitted by the surface
+    virtual auto emitted() const -> color<T>
+    {
+        return {};
+    }
+
+    /// @return true if the material emits light, so it is used for explicit light sampling
+    virtual auto is_emissive() const -> bool
+    {
+        return false;
+    }
+
+    /// Solid angle density with which scatter() picks the direction of the scattered ray. Materials
+    /// returning a non-zero value must have an attenuation equal to BSDF * cosine / pdf for any direction,
+    /// so they can also be lit through explicit light sampling.
+    /// @return 0 for materials that cannot be combined with light sampling (e.g. specular ones)
+    virtual auto scattering_pdf(const ray<T> &, const hit_record<T> &, const ray<T> &) const -> T
+    {
+        return 0;
+    }
+
+    /// @return Albedo of ideal diffuse materials, whose reflected radiance is the albedo times a factor that
+    ///         only depends on the incident light, so the latter can be shared between surfaces
+    virtual auto diffuse_albedo() const -> std::optional<color<T>>
+    {
+        return std::nullopt;
+    }
 };
 
 template<typename T>
@@ -29,7 +57,7 @@ class lambertian : public material<T>
 public:
     lambertian(color<T> t_albedo) : m_albedo{std::move(t_albedo)} {}
 
-    auto scatter(ray<T>, hit_record<T> rec) -> std::optional<scatter_result<T>> const override
+    auto scatter(const ray<T> &, const hit_record<T> &rec) const -> std::optional<scatter_result<T>> override
     {
         auto scatter_direction = rec.normal + rt::random_unit_vec_on_sphere<T>();
 
@@ -40,6 +68,18 @@ public:
         return scatter_result{{rec.pos, scatter_direction}, m_albedo};
     }
 
+    auto scattering_pdf(const ray<T> &, const hit_record<T> &rec, const ray<T> &scattered) const -> T override
+    {
+        // Cosine-weighted hemisphere sampling
+        const auto cos_theta = dot(rec.normal, scattered.direction.unit_vector());
+        return cos_theta < 0 ? 0 : cos_theta / rt::pi;
+    }
+
+    auto diffuse_albedo() const -> std::optional<color<T>> override
+    {
+        return m_albedo;
+    }
+
 private:
     color<T> m_albedo;
 };
@@ -51,7 +91,7 @@ public:
     metal(color<T> t_albedo, T t_fuzz) 
         : m_albedo{std::move(t_albedo)}, m_fuzz{t_fuzz < 1. ? t_fuzz : 1.} {}
 
-    auto scatter(ray<T> r_in, hit_record<T> rec) -> std::optional<scatter_result<T>> const override
+    auto scatter(const ray<T> &r_in, const hit_record<T> &rec) const -> std::optional<scatter_result<T>> override
     {
         const auto reflected = reflect(r_in.direction.unit_vector(), rec.normal);
         return scatter_result{{rec.pos, reflected + m_fuzz * rt::random_unit_vec_on_sphere<T>()}, 
@@ -69,7 +109,7 @@ class dielectric : public material<T>
 public:
     dielectric(const T t_index_of_refraction): m_ir{t_index_of_refraction} {}
 
-    auto scatter(ray<T> r_in, hit_record<T> rec) -> std::optional<scatter_result<T>> const override
+    auto scatter(const ray<T> &r_in, const hit_record<T> &rec) const -> std::optional<scatter_result<T>> override
     {
         const auto attenuation = color{1., 1., 1.};
         const auto refraction_ratio = rec.front_face ? 1. / m_ir : m_ir;
@@ -86,4 +126,29 @@ public:
 
 private:
     T m_ir; // Index of refraction
+};
+
+template<typename T>
+class diffuse_light : public material<T>
+{
+public:
+    diffuse_light(color<T> t_emit) : m_emit{std::move(t_emit)} {}
+
+    auto scatter(const ray<T> &, const hit_record<T> &) const -> std::optional<scatter_result<T>> override
+    {
+        return std::nullopt;
+    }
+
+    auto emitted() const -> color<T> override
+    {
+        return m_emit;
+    }
+
+    auto is_emissive() const -> bool override
+    {
+        return true;
+    }
+
+private:
+    color<T> m_emit;
 };
\ No newline at end of file
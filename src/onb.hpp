@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cmath>
+
+#include "vec3.hpp"
+
+/// Orthonormal basis whose w axis is aligned with a given direction
+template<typename T>
+class onb
+{
+public:
+    explicit onb(const vec3<T> t_w)
+        : m_w{t_w.unit_vector()}
+    {
+        const auto a = std::fabs(m_w.x()) > 0.9 ? vec3<T>{0., 1., 0.} : vec3<T>{1., 0., 0.};
+        m_v = cross(m_w, a).unit_vector();
+        m_u = cross(m_w, m_v);
+    }
+
+    auto u() const -> vec3<T>
+    {
+        return m_u;
+    }
+
+    auto v() const -> vec3<T>
+    {
+        return m_v;
+    }
+
+    auto w() const -> vec3<T>
+    {
+        return m_w;
+    }
+
+    /// @return Vector with coordinates a expressed in world space
+    auto local(const vec3<T> a) const -> vec3<T>
+    {
+        return a.x() * m_u + a.y() * m_v + a.z() * m_w;
+    }
+
+private:
+    vec3<T> m_w;
+    vec3<T> m_u;
+    vec3<T> m_v;
+};
\ No newline at end of file
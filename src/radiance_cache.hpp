@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cmath>
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "color.hpp"
+#include "vec3.hpp"
+
+/// Cache of the light reaching diffuse surfaces, before weighting by their albedo, averaged over the cells of
+/// a spatial hash grid keyed on the hit position and the dominant axis of its normal. Surfaces of different
+/// colors sharing a cell reflect the same incident light in their own color. It is filled progressively by
+/// the paths traced, and once a cell has enough samples with a low enough error, later paths reaching it can
+/// stop and use the cached value instead. This trades some bias, bounded by the cell size, for shorter paths.
+template<typename T>
+class radiance_cache
+{
+public:
+    /// @param t_cell_size Side of the grid cells, the larger the more bias
+    /// @param t_max_entries Maximum number of cells stored. The table holding them is allocated once, here,
+    ///        so rendering with the cache does not allocate
+    /// @param t_min_samples Samples a cell needs before being used
+    /// @param t_max_relative_error Maximum standard error of the mean luminance of a cell, relative to the mean,
+    ///        for the cell to be used
+    radiance_cache(const T t_cell_size, const std::size_t t_max_entries, const int t_min_samples = 8,
+                   const T t_max_relative_error = 0.25)
+        : m_cell_size{t_cell_size}, m_max_entries{t_max_entries}, m_min_samples{t_min_samples},
+          m_max_relative_error{t_max_relative_error}
+    {
+        if (!(m_cell_size > 0) || m_max_entries < 1 || m_min_samples < 2) {
+            throw std::invalid_argument{"Invalid radiance cache settings"};
+        }
+
+        // At most half of the slots are used, which keeps probe sequences short and always ends them
+        m_slots.resize(std::bit_ceil(2 * m_max_entries));
+    }
+
+    /// @return Cached incident light around pos, to be weighted by the albedo, if the cell is reliable enough
+    auto lookup(const coord<T> &pos, const vec3<T> &normal) -> std::optional<color<T>>
+    {
+        const auto &s = probe(key_of(pos, normal));
+        if (s.data.count == 0 || !s.data.reliable(m_min_samples, m_max_relative_error)) {
+            ++m_misses;
+            return std::nullopt;
+        }
+
+        ++m_hits;
+        return static_cast<color<T>>(s.data.sum / static_cast<T>(s.data.count));
+    }
+
+    /// Adds a sample of the light reaching pos, unless the cache is full and its cell is new
+    auto add(const coord<T> &pos, const vec3<T> &normal, const color<T> &incident) -> void
+    {
+        const auto key = key_of(pos, normal);
+        auto &s = probe(key);
+        if (s.data.count == 0) {
+            if (m_size >= m_max_entries) {
+                return;
+            }
+            s.key = key;
+            ++m_size;
+        }
+
+        auto &e = s.data;
+        const auto l = luminance(incident);
+        e.sum += incident;
+        e.sum_squared_luminance += l * l;
+        ++e.count;
+    }
+
+    auto size() const -> std::size_t
+    {
+        return m_size;
+    }
+
+    auto hits() const -> std::size_t
+    {
+        return m_hits;
+    }
+
+    auto misses() const -> std::size_t
+    {
+        return m_misses;
+    }
+
+private:
+    struct cell_key
+    {
+        std::int64_t x;
+        std::int64_t y;
+        std::int64_t z;
+        int normal_bin;
+
+        auto operator==(const cell_key &) const -> bool = default;
+    };
+
+    struct cell_hash
+    {
+        auto operator()(const cell_key &k) const -> std::size_t
+        {
+            auto h = static_cast<std::uint64_t>(k.x) * 0x9E3779B97F4A7C15u;
+            h ^= static_cast<std::uint64_t>(k.y) * 0xC2B2AE3D27D4EB4Fu + (h << 6) + (h >> 2);
+            h ^= static_cast<std::uint64_t>(k.z) * 0x165667B19E3779F9u + (h << 6) + (h >> 2);
+            h ^= static_cast<std::uint64_t>(k.normal_bin) + (h << 6) + (h >> 2);
+
+            // Mixes the high bits into the low ones, which select the slot
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCDu;
+            h ^= h >> 33;
+            return h;
+        }
+    };
+
+    struct entry
+    {
+        vec3<T> sum{};
+        T sum_squared_luminance{0};
+        int count{0};   // 0 for the empty slots of the table
+
+        auto reliable(const int min_samples, const T max_relative_error) const -> bool
+        {
+            if (count < min_samples) {
+                return false;
+            }
+            const auto n = static_cast<T>(count);
+            const auto mean = luminance(static_cast<color<T>>(sum / n));
+            const auto variance = std::max(T{0}, sum_squared_luminance / n - mean * mean);
+            return std::sqrt(variance / n) <= max_relative_error * mean;
+        }
+    };
+
+    struct slot
+    {
+        cell_key key{};
+        entry data{};
+    };
+
+    T m_cell_size;
+    std::size_t m_max_entries;
+    int m_min_samples;
+    T m_max_relative_error;
+    std::vector<slot> m_slots;      // Open addressing table with linear probing, its size a power of two
+    std::size_t m_size{0};
+    std::size_t m_hits{0};
+    std::size_t m_misses{0};
+
+    /// @return Slot holding the cell, or the empty slot where it would be inserted
+    auto probe(const cell_key &key) -> slot &
+    {
+        const auto mask = m_slots.size() - 1;
+        auto i = cell_hash{}(key) & mask;
+        while (m_slots[i].data.count > 0 && !(m_slots[i].key == key)) {
+            i = (i + 1) & mask;
+        }
+        return m_slots[i];
+    }
+
+    static auto luminance(const color<T> &c) -> T
+    {
+        return 0.2126 * c.r() + 0.7152 * c.g() + 0.0722 * c.b();
+    }
+
+    auto key_of(const coord<T> &pos, const vec3<T> &normal) const -> cell_key
+    {
+        // Surfaces facing different ways within a cell, e.g. both sides of a thin object, must not be mixed
+        auto axis = 0u;
+        for (auto a = 1u; a < 3; ++a) {
+            if (std::fabs(normal[a]) > std::fabs(normal[axis])) {
+                axis = a;
+            }
+        }
+        const auto normal_bin = static_cast<int>(2 * axis) + (normal[axis] < 0 ? 1 : 0);
+
+        const auto cell = [&](const T v) {
+            return static_cast<std::int64_t>(std::floor(v / m_cell_size));
+        };
+        return {cell(pos.x()), cell(pos.y()), cell(pos.z()), normal_bin};
+    }
+};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cmath>
+
 #include <random>
 #include <stdexcept>
 
@@ -7,12 +9,32 @@
 
 namespace rt
 {
+/// Generator shared by all the random functions called from the same thread
+inline auto generator() -> std::mt19937 &
+{
+    thread_local std::mt19937 generator;
+    return generator;
+}
+
+/// Restarts the shared generator of the calling thread, so the following random sequence is reproducible
+inline auto seed(const std::mt19937::result_type value = std::mt19937::default_seed) -> void
+{
+    generator().seed(value);
+}
+
 template<typename T>
 inline auto random_t(const T min = 0., const T max = 1.) -> T
 {
-    static std::uniform_real_distribution<T> distribution{min, max};
-    static std::mt19937 generator;
-    return distribution(generator);
+    auto distribution = std::uniform_real_distribution<T>{min, max};
+    return distribution(generator());
+}
+
+/// Same as random_t(), drawing from a caller owned generator, e.g. one per thread
+template<typename T>
+inline auto random_t(std::mt19937 &gen, const T min, const T max) -> T
+{
+    auto distribution = std::uniform_real_distribution<T>{min, max};
+    return distribution(gen);
 }
 
 template<typename T>
@@ -61,5 +83,21 @@ inline auto random_vec_in_unit_disk() -> vec3<T>
 
     throw std::logic_error{"random_in_unit_disc: vec not found"};
 }
+
+/// @return Random direction, in a frame whose z axis points to the center of a sphere of the given
+///         radius at the given squared distance, uniformly distributed over the cone subtended by it
+template<typename T>
+inline auto random_vec_to_sphere(const T radius, const T distance_squared) -> vec3<T>
+{
+    const auto r1 = random_t<T>();
+    const auto r2 = random_t<T>();
+    const auto z = 1 + r2 * (std::sqrt(1 - radius * radius / distance_squared) - 1);
+
+    const auto phi = 2 * pi * r1;
+    const auto x = std::cos(phi) * std::sqrt(1 - z * z);
+    const auto y = std::sin(phi) * std::sqrt(1 - z * z);
+
+    return {x, y, z};
+}
 } // namespace rt
  
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "rt_core.hpp"
+
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Types copied on the per-ray path hold no owning pointers, so copying them never touches a reference count
+static_assert(std::is_trivially_copyable_v<ray<rt::scalar_type>>);
+static_assert(std::is_trivially_copyable_v<hit_record<rt::scalar_type>>);
+static_assert(std::is_trivially_copyable_v<scatter_result<rt::scalar_type>>);
+
+template class camera<rt::scalar_type>;
+template class framebuffer<rt::scalar_type>;
+template class hittable_list<rt::scalar_type>;
+template class sphere<rt::scalar_type>;
+template class lambertian<rt::scalar_type>;
+template class metal<rt::scalar_type>;
+template class dielectric<rt::scalar_type>;
+template class diffuse_light<rt::scalar_type>;
+template class ppm_sink<rt::scalar_type>;
+template class pfm_sink<rt::scalar_type>;
+
+namespace rt
+{
+auto render(const scene &s, camera<scalar_type> cam,
+            const std::optional<std::chrono::steady_clock::time_point> deadline,
+            const std::stop_token stop) -> framebuffer<scalar_type>
+{
+    if (deadline || stop.stop_possible()) {
+        return cam.render_progressive(s.world, s.lights, deadline.value_or(std::chrono::steady_clock::time_point::max()), stop);
+    }
+    return cam.render_image(s.world, s.lights);
+}
+
+auto scene_description::read(std::istream &in) -> scene_description
+{
+    auto description = scene_description{};
+
+    auto line = std::string{};
+    while (std::getline(in, line)) {
+        auto tokens = std::istringstream{line};
+        auto normalized = std::string{};
+        auto token = std::string{};
+        while (tokens >> token) {
+            normalized += normalized.empty() ? token : ' ' + token;
+        }
+
+        if (normalized == "end") {
+            break;
+        }
+        if (!normalized.empty() && normalized.front() != '#') {
+            description.m_text += normalized + '\n';
+        }
+    }
+    return description;
+}
+
+auto scene_description::hash() const -> std::uint64_t
+{
+    auto h = std::uint64_t{14695981039346656037u};
+    for (const auto c : m_text) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211u;
+    }
+    return h;
+}
+
+auto scene_description::build() const -> std::shared_ptr<scene>
+{
+    using material_ptr = std::shared_ptr<material<scalar_type>>;
+
+    auto materials = std::unordered_map<std::string, material_ptr>{};
+    auto world = hittable_list<scalar_type>{};
+
+    auto in = std::istringstream{m_text};
+    auto line = std::string{};
+    while (std::getline(in, line)) {
+        auto tokens = std::istringstream{line};
+        auto kind = std::string{};
+        tokens >> kind;
+
+        const auto read_color = [&] {
+            auto r = 0.;
+            auto g = 0.;
+            auto b = 0.;
+            tokens >> r >> g >> b;
+            return color{r, g, b};
+        };
+
+        if (kind == "material") {
+            auto name = std::string{};
+            auto type = std::string{};
+            tokens >> name >> type;
+
+            auto mat = material_ptr{};
+            if (type == "lambertian") {
+                mat = std::make_shared<lambertian<scalar_type>>(read_color());
+            } else if (type == "metal") {
+                const auto albedo = read_color();
+                auto fuzz = 0.;
+                tokens >> fuzz;
+                mat = std::make_shared<metal<scalar_type>>(albedo, fuzz);
+            } else if (type == "dielectric") {
+                auto ir = 0.;
+                tokens >> ir;
+                mat = std::make_shared<dielectric<scalar_type>>(ir);
+            } else if (type == "light") {
+                mat = std::make_shared<diffuse_light<scalar_type>>(read_color());
+            } else {
+                throw std::invalid_argument{"Unknown material type: " + type};
+            }
+            materials[name] = std::move(mat);
+        } else if (kind == "sphere") {
+            auto x = 0.;
+            auto y = 0.;
+            auto z = 0.;
+            auto radius = 0.;
+            auto name = std::string{};
+            tokens >> x >> y >> z >> radius >> name;
+
+            const auto it = materials.find(name);
+            if (it == materials.end()) {
+                throw std::invalid_argument{"Unknown material: " + name};
+            }
+            world.add(std::make_shared<sphere<scalar_type>>(coord{x, y, z}, radius, it->second));
+        } else {
+            throw std::invalid_argument{"Unknown scene element: " + kind};
+        }
+
+        if (tokens.fail()) {
+            throw std::invalid_argument{"Malformed scene line: " + line};
+        }
+    }
+
+    return std::make_shared<scene>(std::move(world));
+}
+} // namespace rt
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <stop_token>
+#include <string>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "image_sink.hpp"
+#include "material.hpp"
+#include "rtweekend.hpp"
+#include "sphere.hpp"
+
+// The scalar type instantiations are compiled once into the rt_core library
+extern template class camera<rt::scalar_type>;
+extern template class framebuffer<rt::scalar_type>;
+extern template class hittable_list<rt::scalar_type>;
+extern template class sphere<rt::scalar_type>;
+extern template class lambertian<rt::scalar_type>;
+extern template class metal<rt::scalar_type>;
+extern template class dielectric<rt::scalar_type>;
+extern template class diffuse_light<rt::scalar_type>;
+extern template class ppm_sink<rt::scalar_type>;
+extern template class pfm_sink<rt::scalar_type>;
+
+namespace rt
+{
+/// Objects to render, along with the emissive ones used for explicit light sampling
+struct scene
+{
+    hittable_list<scalar_type> world;
+    hittable_list<scalar_type> lights;
+
+    explicit scene(hittable_list<scalar_type> t_world)
+        : world{std::move(t_world)}, lights{world.lights()}
+    {}
+};
+
+/// Renders the scene as seen by the camera
+/// @param deadline If set, rendering is progressive and stops at the deadline with the samples taken so far
+auto render(const scene &s, camera<scalar_type> cam,
+            std::optional<std::chrono::steady_clock::time_point> deadline = std::nullopt,
+            std::stop_token stop = {}) -> framebuffer<scalar_type>;
+
+/// Scene description in a line based text format. Blank lines and lines starting with '#' are ignored:
+///
+///     material <name> lambertian <r> <g> <b>
+///     material <name> metal <r> <g> <b> <fuzz>
+///     material <name> dielectric <index_of_refraction>
+///     material <name> light <r> <g> <b>
+///     sphere <x> <y> <z> <radius> <material name>
+class scene_description
+{
+public:
+    /// Reads lines up to a line containing only "end", or up to the end of the stream
+    static auto read(std::istream &in) -> scene_description;
+
+    /// Description with lines normalized to single spaces between tokens, used to identify the scene
+    auto text() const -> const std::string &
+    {
+        return m_text;
+    }
+
+    /// @return 64-bit FNV-1a hash of the normalized text
+    auto hash() const -> std::uint64_t;
+
+    /// @throws std::invalid_argument if the description is malformed
+    auto build() const -> std::shared_ptr<scene>;
+
+private:
+    std::string m_text;
+};
+} // namespace rt
\ No newline at end of file
@@ -9,6 +9,7 @@ using scalar_type = double;
 
 constexpr auto infinity = std::numeric_limits<scalar_type>::infinity();
 constexpr auto pi = 3.1415926535897932385;
+constexpr auto surface_epsilon = 0.001;   // Start rays slightly above the surface, to avoid rounding errors
 
 template<typename T>
 inline auto degrees_to_radians(const T degrees) -> T
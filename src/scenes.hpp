@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cmath>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "camera.hpp"
+#include "color.hpp"
+#include "hittable_list.hpp"
+#include "material.hpp"
+#include "random.hpp"
+#include "sphere.hpp"
+#include "vec3.hpp"
+
+/// Final scene of "Ray Tracing in One Weekend": a large ground sphere, three big spheres and
+/// a grid of small random spheres with diffuse, metal and glass materials
+template<typename T>
+auto random_spheres_scene() -> hittable_list<T>
+{
+    hittable_list<T> world;
+
+    const auto ground_material = std::make_shared<lambertian<T>>(color{0.5, 0.5, 0.5});
+    world.add(std::make_shared<sphere<T>>(coord{0., -1000., 0.}, 1000., ground_material));
+
+    for (int a = -11; a < 11; a++) {
+        for (int b = -11; b < 11; b++) {
+            const auto choose_mat = rt::random_t<T>();
+            const auto center = coord{a + 0.9 * rt::random_t<T>(), 0.2, b + 0.9 * rt::random_t<T>()};
+
+            if ((center - coord{4., 0.2, 0.}).length() > 0.9) {
+                std::shared_ptr<material<T>> sphere_material;
+
+                if (choose_mat < 0.8) {
+                    // diffuse
+                    const auto albedo = static_cast<color<T>>(rt::random_v<T>() * rt::random_v<T>());
+                    sphere_material = std::make_shared<lambertian<T>>(albedo);
+                    world.add(std::make_shared<sphere<T>>(center, 0.2, sphere_material));
+                } else if (choose_mat < 0.95) {
+                    // metal
+                    const auto albedo = static_cast<color<T>>(rt::random_v(0.5, 1.));
+                    const auto fuzz = rt::random_t(0., 0.5);
+                    sphere_material = std::make_shared<metal<T>>(albedo, fuzz);
+                    world.add(std::make_shared<sphere<T>>(center, 0.2, sphere_material));
+                } else {
+                    // glass
+                    sphere_material = std::make_shared<dielectric<T>>(1.5);
+                    world.add(std::make_shared<sphere<T>>(center, 0.2, sphere_material));
+                }
+            }
+        }
+    }
+
+    const auto material1 = std::make_shared<dielectric<T>>(1.5);
+    world.add(std::make_shared<sphere<T>>(coord{0., 1., 0.}, 1.0, material1));
+
+    auto material2 = std::make_shared<lambertian<T>>(color{0.4, 0.2, 0.1});
+    world.add(std::make_shared<sphere<T>>(coord{-4., 1., 0.}, 1.0, material2));
+
+    auto material3 = std::make_shared<metal<T>>(color{0.7, 0.6, 0.5}, 0.0);
+    world.add(std::make_shared<sphere<T>>(coord{4., 1., 0.}, 1.0, material3));
+
+    return world;
+}
+
+/// Camera of the final render of "Ray Tracing in One Weekend", looking at random_spheres_scene() with a
+/// shallow depth of field
+template<typename T>
+auto random_spheres_camera() -> camera<T>
+{
+    camera<T> cam;
+
+    cam.aspect_ratio = 16. / 9.;
+    cam.image_width = 1200;
+    cam.samples_per_pixel = 500;
+    cam.max_depth = 50;
+
+    cam.vfov = 20.;
+    cam.lookfrom = coord{13.,  2.,  3.};
+    cam.lookat   = coord{ 0.,  0.,  0.};
+    cam.vup      = vec3 { 0. , 1.,  0.};
+
+    cam.defocus_angle   = .6;
+    cam.focus_dist      = 10.;
+
+    return cam;
+}
+
+/// A few spheres on the ground, lit only by a small and bright spherical light. Meant to be rendered
+/// with a black background, where paths rarely find the light unless it is sampled explicitly
+template<typename T>
+auto small_light_scene() -> hittable_list<T>
+{
+    hittable_list<T> world;
+
+    const auto ground_material = std::make_shared<lambertian<T>>(color{0.5, 0.5, 0.5});
+    world.add(std::make_shared<sphere<T>>(coord{0., -1000., 0.}, 1000., ground_material));
+
+    const auto diffuse_material = std::make_shared<lambertian<T>>(color{0.7, 0.3, 0.2});
+    world.add(std::make_shared<sphere<T>>(coord{-1.2, 0.5, 0.}, 0.5, diffuse_material));
+
+    const auto white_material = std::make_shared<lambertian<T>>(color{0.8, 0.8, 0.8});
+    world.add(std::make_shared<sphere<T>>(coord{0., 0.5, 0.}, 0.5, white_material));
+
+    const auto metal_material = std::make_shared<metal<T>>(color{0.8, 0.8, 0.7}, 0.2);
+    world.add(std::make_shared<sphere<T>>(coord{1.2, 0.5, 0.}, 0.5, metal_material));
+
+    const auto light_material = std::make_shared<diffuse_light<T>>(color{150., 150., 150.});
+    world.add(std::make_shared<sphere<T>>(coord{0., 4., 0.5}, 0.2, light_material));
+
+    return world;
+}
+
+/// Camera looking down at the spheres of small_light_scene(), with the black background the scene needs
+template<typename T>
+auto small_light_camera() -> camera<T>
+{
+    camera<T> cam;
+
+    cam.aspect_ratio = 1.;
+    cam.image_width = 400;
+    cam.samples_per_pixel = 100;
+    cam.max_depth = 10;
+    cam.background = color{0., 0., 0.};
+
+    cam.vfov = 40.;
+    cam.lookfrom = coord{0., 1.5, 6.};
+    cam.lookat   = coord{0., 0.5, 0.};
+    cam.vup      = vec3 {0., 1., 0.};
+
+    return cam;
+}
+
+/// Objects of stress_scene() built from the same random generator, always in the same chunk so the
+/// scene does not depend on the thread count
+constexpr auto stress_scene_chunk_size = std::size_t{1} << 16;
+
+/// Deterministic scene of count random small spheres scattered in a cube whose volume grows with the count,
+/// so the density is the same at every size. Chunks of spheres are built in parallel, each one with its own
+/// generator seeded from seed and the chunk index. Materials come from a small shared palette.
+template<typename T>
+auto stress_scene(const std::size_t count, const std::uint32_t seed, const unsigned thread_count) -> hittable_list<T>
+{
+    constexpr auto palette_size = 64u;
+    constexpr auto spacing = 1.;  // Mean distance between neighbouring sphere centers
+
+    auto palette_generator = std::mt19937{seed};
+    auto palette = std::vector<std::shared_ptr<material<T>>>{};
+    for (auto m = 0u; m < palette_size; ++m) {
+        const auto albedo = color{rt::random_t<T>(palette_generator, 0., 1.), rt::random_t<T>(palette_generator, 0., 1.),
+                                  rt::random_t<T>(palette_generator, 0., 1.)};
+        if (m % 4 == 0) {
+            palette.push_back(std::make_shared<metal<T>>(albedo, rt::random_t<T>(palette_generator, 0., 0.5)));
+        } else {
+            palette.push_back(std::make_shared<lambertian<T>>(albedo));
+        }
+    }
+
+    const auto half_side = spacing * std::cbrt(static_cast<T>(count)) / 2;
+
+    hittable_list<T> world;
+    world.objects.resize(count);
+
+    const auto chunk_count = (count + stress_scene_chunk_size - 1) / stress_scene_chunk_size;
+    auto next_chunk = std::atomic<std::size_t>{0};
+    const auto build_chunks = [&] {
+        for (auto chunk = next_chunk++; chunk < chunk_count; chunk = next_chunk++) {
+            auto seq = std::seed_seq{seed, static_cast<std::uint32_t>(chunk), static_cast<std::uint32_t>(chunk >> 32)};
+            auto generator = std::mt19937{seq};
+
+            const auto end = std::min(count, (chunk + 1) * stress_scene_chunk_size);
+            for (auto i = chunk * stress_scene_chunk_size; i < end; ++i) {
+                const auto center = coord{rt::random_t<T>(generator, -half_side, half_side),
+                                          rt::random_t<T>(generator, -half_side, half_side),
+                                          rt::random_t<T>(generator, -half_side, half_side)};
+                const auto radius = rt::random_t<T>(generator, 0.1, 0.3);
+                const auto &mat = palette[static_cast<std::size_t>(rt::random_t<T>(generator, 0., palette_size)) % palette_size];
+                world.objects[i] = std::make_shared<sphere<T>>(center, radius, mat);
+            }
+        }
+    };
+
+    {
+        auto threads = std::vector<std::jthread>{};
+        for (auto t = 1u; t < std::max(thread_count, 1u); ++t) {
+            threads.emplace_back(build_chunks);
+        }
+        build_chunks();
+    } // Joins the threads
+
+    return world;
+}
\ No newline at end of file
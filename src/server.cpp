@@ -0,0 +1,426 @@
+// Long running render server. Scenes are kept in memory, keyed by the hash of their description, so
+// repeated jobs skip parsing and scene construction. Jobs are read from stdin, or from the connections
+// to a local UNIX socket, with a line based protocol:
+//
+//   scene                  Followed by a scene description (see rt::scene_description) and a line "end".
+//                          Replies "ok <hash>", building the scene only if it is not cached yet
+//   render <hash> [key=value...]
+//                          Replies "image <byte count>" followed by the image, or "error <message>".
+//                          Keys: width, aspect, spp, depth, vfov, from, at, up, defocus, focus,
+//                          background (vectors as x,y,z), budget (seconds) and format (ppm or pfm)
+//   stats                  Replies "ok scenes=<count> hits=<count> misses=<count>"
+//   quit                   Ends the session
+//
+// Socket connections are served concurrently, each one on its own thread, and closed after waiting for
+// the client for longer than the timeout.
+//
+//   rt_server [--socket <path>] [--cache <scene count>] [--timeout <seconds>]
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "rt_core.hpp"
+
+namespace
+{
+/// Least recently used cache of built scenes, shared by the connections served concurrently
+class scene_cache
+{
+public:
+    /// @throws std::invalid_argument if the capacity is 0, as scenes would be evicted as soon as inserted
+    explicit scene_cache(const std::size_t t_capacity) : m_capacity{t_capacity}
+    {
+        if (m_capacity < 1) {
+            throw std::invalid_argument{"The scene cache must hold at least one scene"};
+        }
+    }
+
+    /// @return Hash of the scene, which is built unless already cached
+    /// @throws std::runtime_error if a different cached scene has the same hash
+    auto insert(const rt::scene_description &description) -> std::uint64_t
+    {
+        const auto hash = description.hash();
+        {
+            const auto lock = std::scoped_lock{m_mutex};
+            if (touch(hash, description.text())) {
+                ++m_hits;
+                return hash;
+            }
+        }
+
+        // Built without the lock, so other connections are not blocked meanwhile. Descriptions that fail
+        // to build are not counted as misses.
+        auto scene = description.build();
+
+        const auto lock = std::scoped_lock{m_mutex};
+        ++m_misses;
+        if (touch(hash, description.text())) {
+            return hash;    // Built by another connection meanwhile
+        }
+        m_entries.push_front({hash, description.text(), std::move(scene)});
+        m_index[hash] = m_entries.begin();
+        if (m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().hash);
+            m_entries.pop_back();
+        }
+        return hash;
+    }
+
+    auto find(const std::uint64_t hash) -> std::shared_ptr<const rt::scene>
+    {
+        const auto lock = std::scoped_lock{m_mutex};
+        const auto it = m_index.find(hash);
+        if (it == m_index.end()) {
+            return nullptr;
+        }
+
+        ++m_hits;
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->scene;
+    }
+
+    auto size() const -> std::size_t
+    {
+        const auto lock = std::scoped_lock{m_mutex};
+        return m_entries.size();
+    }
+
+    auto hits() const -> std::size_t
+    {
+        const auto lock = std::scoped_lock{m_mutex};
+        return m_hits;
+    }
+
+    auto misses() const -> std::size_t
+    {
+        const auto lock = std::scoped_lock{m_mutex};
+        return m_misses;
+    }
+
+private:
+    struct entry
+    {
+        std::uint64_t hash;
+        std::string text;   // Normalized description, telling apart scenes whose hashes collide
+        std::shared_ptr<const rt::scene> scene;
+    };
+
+    std::size_t m_capacity;
+    mutable std::mutex m_mutex;
+    std::list<entry> m_entries;     // Most recently used first
+    std::unordered_map<std::uint64_t, std::list<entry>::iterator> m_index;
+    std::size_t m_hits{0};
+    std::size_t m_misses{0};
+
+    /// Marks the scene as the most recently used one. Must be called with the lock held.
+    /// @return true if the scene is cached
+    auto touch(const std::uint64_t hash, const std::string &text) -> bool
+    {
+        const auto it = m_index.find(hash);
+        if (it == m_index.end()) {
+            return false;
+        }
+        if (it->second->text != text) {
+            throw std::runtime_error{"Scene hash collides with a cached scene"};
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return true;
+    }
+};
+
+/// Stream buffer over a file descriptor, used for socket connections
+class fd_streambuf : public std::streambuf
+{
+public:
+    explicit fd_streambuf(const int t_fd) : m_fd{t_fd}
+    {
+        setg(m_in.data(), m_in.data(), m_in.data());
+        setp(m_out.data(), m_out.data() + m_out.size());
+    }
+
+    ~fd_streambuf() override
+    {
+        sync();
+    }
+
+protected:
+    auto underflow() -> int_type override
+    {
+        const auto count = ::read(m_fd, m_in.data(), m_in.size());
+        if (count <= 0) {
+            return traits_type::eof();
+        }
+        setg(m_in.data(), m_in.data(), m_in.data() + count);
+        return traits_type::to_int_type(m_in[0]);
+    }
+
+    auto overflow(const int_type c) -> int_type override
+    {
+        if (sync() != 0) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(c, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+        return traits_type::not_eof(c);
+    }
+
+    /// Writes with MSG_NOSIGNAL, so a client that disconnects early fails the write instead of raising SIGPIPE
+    auto sync() -> int override
+    {
+        for (auto begin = pbase(); begin < pptr(); ) {
+            const auto count = ::send(m_fd, begin, static_cast<std::size_t>(pptr() - begin), MSG_NOSIGNAL);
+            if (count <= 0) {
+                return -1;
+            }
+            begin += count;
+        }
+        setp(m_out.data(), m_out.data() + m_out.size());
+        return 0;
+    }
+
+private:
+    int m_fd;
+    std::array<char, 4096> m_in{};
+    std::array<char, 4096> m_out{};
+};
+
+auto parse_vec(const std::string &value) -> vec3<rt::scalar_type>
+{
+    auto in = std::istringstream{value};
+    auto v = vec3<rt::scalar_type>{};
+    auto separator = ',';
+    in >> v.x() >> separator >> v.y() >> separator >> v.z();
+    if (!in) {
+        throw std::invalid_argument{"Invalid vector: " + value};
+    }
+    return v;
+}
+
+auto render_job(scene_cache &cache, std::istringstream &args, std::ostream &out) -> void
+{
+    auto hash = std::uint64_t{};
+    args >> std::hex >> hash >> std::dec;
+    const auto scene = cache.find(hash);
+    if (!scene) {
+        throw std::invalid_argument{"Unknown scene"};
+    }
+
+    auto cam = camera<rt::scalar_type>{};
+    auto deadline = std::optional<std::chrono::steady_clock::time_point>{};
+    auto format = std::string{"ppm"};
+
+    auto arg = std::string{};
+    while (args >> arg) {
+        const auto separator = arg.find('=');
+        if (separator == std::string::npos) {
+            throw std::invalid_argument{"Invalid argument: " + arg};
+        }
+        const auto key = arg.substr(0, separator);
+        const auto value = arg.substr(separator + 1);
+
+        if (key == "width") {
+            cam.image_width = std::stoi(value);
+        } else if (key == "aspect") {
+            cam.aspect_ratio = std::stod(value);
+        } else if (key == "spp") {
+            cam.samples_per_pixel = std::stoi(value);
+        } else if (key == "depth") {
+            cam.max_depth = std::stoi(value);
+        } else if (key == "vfov") {
+            cam.vfov = std::stod(value);
+        } else if (key == "from") {
+            cam.lookfrom = static_cast<coord<rt::scalar_type>>(parse_vec(value));
+        } else if (key == "at") {
+            cam.lookat = static_cast<coord<rt::scalar_type>>(parse_vec(value));
+        } else if (key == "up") {
+            cam.vup = parse_vec(value);
+        } else if (key == "defocus") {
+            cam.defocus_angle = std::stod(value);
+        } else if (key == "focus") {
+            cam.focus_dist = std::stod(value);
+        } else if (key == "background") {
+            cam.background = static_cast<color<rt::scalar_type>>(parse_vec(value));
+        } else if (key == "budget") {
+            deadline = std::chrono::steady_clock::now()
+                    + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(std::stod(value)));
+        } else if (key == "format" && (value == "ppm" || value == "pfm")) {
+            format = value;
+        } else {
+            throw std::invalid_argument{"Invalid argument: " + arg};
+        }
+    }
+
+    const auto image = rt::render(*scene, cam, deadline);
+
+    auto encoded = std::ostringstream{};
+    if (format == "pfm") {
+        image.write_pfm(encoded);
+    } else {
+        auto sink = ppm_sink<rt::scalar_type>{encoded};
+        sink.begin(image.width(), image.height());
+        sink.write_tile(0, 0, image);
+        sink.end();
+    }
+
+    const auto data = encoded.str();
+    out << "image " << data.size() << '\n' << data;
+}
+
+/// @return Hash in hexadecimal, formatted apart from the reply stream so its base flags are not changed
+auto format_hash(const std::uint64_t hash) -> std::string
+{
+    auto formatted = std::ostringstream{};
+    formatted << std::hex << hash;
+    return formatted.str();
+}
+
+/// Serves requests until the input ends, a "quit" request, or a failed reply
+auto serve(scene_cache &cache, std::istream &in, std::ostream &out) -> void
+{
+    auto line = std::string{};
+    while (std::getline(in, line)) {
+        auto args = std::istringstream{line};
+        auto request = std::string{};
+        if (!(args >> request)) {
+            continue;
+        }
+
+        try {
+            if (request == "scene") {
+                const auto description = rt::scene_description::read(in);
+                const auto hash = cache.insert(description);
+                out << "ok " << format_hash(hash) << '\n';
+            } else if (request == "render") {
+                render_job(cache, args, out);
+            } else if (request == "stats") {
+                out << "ok scenes=" << cache.size() << " hits=" << cache.hits() << " misses=" << cache.misses() << '\n';
+            } else if (request == "quit") {
+                break;
+            } else {
+                out << "error Unknown request: " << request << '\n';
+            }
+        } catch (const std::exception &e) {
+            out << "error " << e.what() << '\n';
+        }
+        // The client is gone, so there is no one to reply to
+        if (!out.flush()) {
+            break;
+        }
+    }
+}
+
+/// @param timeout_seconds Time after which connections waiting to read or write are closed
+auto serve_socket(scene_cache &cache, const std::string &path, const unsigned timeout_seconds) -> void
+{
+    auto address = sockaddr_un{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument{"Socket path too long"};
+    }
+    std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    const auto listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        throw std::runtime_error{"Cannot create socket"};
+    }
+    ::unlink(path.c_str());
+    if (::bind(listener, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || ::listen(listener, 8) != 0) {
+        ::close(listener);
+        throw std::runtime_error{"Cannot listen on " + path};
+    }
+
+    std::clog << "Listening on " << path << '\n';
+    while (true) {
+        const auto connection = ::accept(listener, nullptr, nullptr);
+        if (connection < 0) {
+            const auto error = errno;
+            if (error == EINTR || error == ECONNABORTED || error == EPROTO) {
+                continue;
+            }
+            if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+                // Out of resources, so wait for other connections to release them
+                std::this_thread::sleep_for(std::chrono::milliseconds{100});
+                continue;
+            }
+            ::close(listener);
+            throw std::runtime_error{std::string{"Cannot accept connections: "} + std::strerror(error)};
+        }
+
+        // Clients idle for too long end their session, so they do not keep a thread forever
+        const auto timeout = timeval{static_cast<time_t>(timeout_seconds), 0};
+        ::setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ::setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        // Each connection is served on its own thread, so slow clients do not delay the others. Threads are
+        // detached as the server runs until it is killed.
+        try {
+            std::thread{[&cache, connection] {
+                {
+                    auto buffer = fd_streambuf{connection};
+                    auto stream = std::iostream{&buffer};
+                    serve(cache, stream, stream);
+                }
+                ::close(connection);
+            }}.detach();
+        } catch (const std::system_error &e) {
+            std::cerr << "Cannot serve connection: " << e.what() << '\n';
+            ::close(connection);
+        }
+    }
+}
+} // namespace
+
+auto main(int argc, char *argv[]) -> int
+{
+    const auto args = std::vector<std::string>(argv, argv + argc);
+
+    // Replies to stdout must not kill the server if the reader goes away either
+    std::signal(SIGPIPE, SIG_IGN);
+
+    try {
+        auto socket_path = std::string{};
+        auto capacity = std::size_t{8};
+        auto timeout_seconds = 60u;
+        for (auto i = std::size_t{1}; i + 1 < args.size(); i += 2) {
+            if (args[i] == "--socket") {
+                socket_path = args[i + 1];
+            } else if (args[i] == "--cache") {
+                capacity = std::stoul(args[i + 1]);
+            } else if (args[i] == "--timeout") {
+                timeout_seconds = static_cast<unsigned>(std::stoul(args[i + 1]));
+            }
+        }
+
+        auto cache = scene_cache{capacity};
+        if (socket_path.empty()) {
+            serve(cache, std::cin, std::cout);
+        } else {
+            serve_socket(cache, socket_path, timeout_seconds);
+        }
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << '\n';
+        return 1;
+    }
+}
\ No newline at end of file
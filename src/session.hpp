@@ -0,0 +1,427 @@
+#pragma once
+
+#include <cmath>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "camera.hpp"
+#include "framebuffer.hpp"
+#include "hittable_list.hpp"
+#include "material.hpp"
+#include "sphere.hpp"
+#include "vec3.hpp"
+
+/// Set of indices below a fixed size, stored as a bitset
+class index_set
+{
+public:
+    explicit index_set(const std::size_t t_size) : m_words((t_size + 63) / 64) {}
+
+    auto insert(const std::size_t i) -> void
+    {
+        m_words[i / 64] |= std::uint64_t{1} << (i % 64);
+    }
+
+    auto contains(const std::size_t i) const -> bool
+    {
+        return (m_words[i / 64] >> (i % 64)) & 1u;
+    }
+
+    /// @return true if both sets, of the same size, have any index in common
+    auto intersects(const index_set &other) const -> bool
+    {
+        for (auto w = std::size_t{0}; w < m_words.size(); ++w) {
+            if (m_words[w] & other.m_words[w]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto clear() -> void
+    {
+        std::ranges::fill(m_words, 0);
+    }
+
+private:
+    std::vector<std::uint64_t> m_words;
+};
+
+/// Uniform grid of cells splitting an axis aligned box, used to record which regions of the scene
+/// each ray segment went through
+template<typename T>
+class tracking_grid
+{
+public:
+    tracking_grid(const coord<T> &t_min, const coord<T> &t_max, const int t_resolution)
+        : m_min{t_min}, m_max{t_max}, m_resolution{t_resolution}
+    {
+        if (m_resolution < 1) {
+            throw std::invalid_argument{"Invalid grid resolution"};
+        }
+        for (auto a = 0u; a < 3; ++a) {
+            m_cell_size[a] = (m_max[a] - m_min[a]) / m_resolution;
+            if (!(m_cell_size[a] > 0)) {
+                throw std::invalid_argument{"Empty grid bounds"};
+            }
+        }
+    }
+
+    auto cell_count() const -> std::size_t
+    {
+        const auto r = static_cast<std::size_t>(m_resolution);
+        return r * r * r;
+    }
+
+    /// @return true if the box between lo and hi lies inside the grid
+    auto contains(const coord<T> &lo, const coord<T> &hi) const -> bool
+    {
+        for (auto a = 0u; a < 3; ++a) {
+            if (lo[a] < m_min[a] || hi[a] > m_max[a]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Adds to cells the cells overlapped by the box between lo and hi, which must lie inside the grid
+    auto insert_box(const coord<T> &lo, const coord<T> &hi, index_set &cells) const -> void
+    {
+        const auto first = cell_of(lo);
+        const auto last = cell_of(hi);
+        for (auto z = first[2]; z <= last[2]; ++z) {
+            for (auto y = first[1]; y <= last[1]; ++y) {
+                for (auto x = first[0]; x <= last[0]; ++x) {
+                    cells.insert(index({x, y, z}));
+                }
+            }
+        }
+    }
+
+    /// Adds to cells the cells crossed by the segment of r between 0 and t_end
+    auto insert_segment(const ray<T> &r, const T t_end, index_set &cells) const -> void
+    {
+        // Clip the segment to the grid bounds
+        auto t0 = T{0};
+        auto t1 = t_end;
+        for (auto a = 0u; a < 3; ++a) {
+            if (r.direction[a] == 0) {
+                if (r.origin[a] < m_min[a] || r.origin[a] > m_max[a]) {
+                    return;
+                }
+                continue;
+            }
+            auto ta = (m_min[a] - r.origin[a]) / r.direction[a];
+            auto tb = (m_max[a] - r.origin[a]) / r.direction[a];
+            if (ta > tb) {
+                std::swap(ta, tb);
+            }
+            t0 = std::max(t0, ta);
+            t1 = std::min(t1, tb);
+            if (t0 > t1) {
+                return;
+            }
+        }
+
+        // Walk the cells along the clipped segment (Amanatides & Woo)
+        auto cell = cell_of(r.at(t0));
+        auto step = std::array<int, 3>{};
+        auto t_next = std::array<T, 3>{};
+        auto t_delta = std::array<T, 3>{};
+        for (auto a = 0u; a < 3; ++a) {
+            const auto d = r.direction[a];
+            step[a] = d > 0 ? 1 : -1;
+            t_next[a] = d == 0 ? rt::infinity
+                    : (m_min[a] + (cell[a] + (d > 0 ? 1 : 0)) * m_cell_size[a] - r.origin[a]) / d;
+            t_delta[a] = d == 0 ? rt::infinity : m_cell_size[a] / std::fabs(d);
+        }
+
+        while (true) {
+            cells.insert(index(cell));
+
+            const auto a = static_cast<std::size_t>(std::ranges::min_element(t_next) - t_next.begin());
+            if (t_next[a] > t1) {
+                return;
+            }
+            cell[a] += step[a];
+            if (cell[a] < 0 || cell[a] >= m_resolution) {
+                return;
+            }
+            t_next[a] += t_delta[a];
+        }
+    }
+
+private:
+    coord<T> m_min;
+    coord<T> m_max;
+    int m_resolution;
+    vec3<T> m_cell_size;
+
+    auto cell_of(const coord<T> &p) const -> std::array<int, 3>
+    {
+        auto cell = std::array<int, 3>{};
+        for (auto a = 0u; a < 3; ++a) {
+            const auto c = static_cast<int>(std::floor((p[a] - m_min[a]) / m_cell_size[a]));
+            cell[a] = std::clamp(c, 0, m_resolution - 1);
+        }
+        return cell;
+    }
+
+    auto index(const std::array<int, 3> &cell) const -> std::size_t
+    {
+        const auto r = static_cast<std::size_t>(m_resolution);
+        return (static_cast<std::size_t>(cell[2]) * r + static_cast<std::size_t>(cell[1])) * r + static_cast<std::size_t>(cell[0]);
+    }
+};
+
+/// Interactive rendering session keeping the scene and the image resident. While rendering, it records for
+/// each tile the objects hit by its paths and the grid cells they went through, so that after editing a sphere
+/// or a material only the tiles that may have changed are rendered again.
+template<typename T>
+class render_session
+{
+public:
+    struct edit_stats
+    {
+        std::size_t tiles_rendered;
+        std::size_t tile_count;
+        std::vector<bool> rendered;     // Flags of the tiles rendered again, in scanline order of tiles
+
+        /// @return Fraction of the tiles whose previous render was kept
+        auto reused_fraction() const -> double
+        {
+            return 1. - static_cast<double>(tiles_rendered) / static_cast<double>(tile_count);
+        }
+    };
+
+    /// Renders the whole image. The world must be a flat list of spheres, which are copied so that edits
+    /// never change the caller's world. Materials are shared, as edits replace them instead of changing them.
+    /// @param t_grid_resolution Cells per axis of the grid used to track where paths went
+    /// @throws std::invalid_argument if the camera uses a radiance cache, whose hits hide the segments they stand
+    ///         for from the tracking, and whose cells would keep the light of before each edit
+    render_session(const hittable_list<T> &t_world, camera<T> t_camera, const int t_tile_size = 16, const int t_grid_resolution = 32)
+        : m_world{copy_spheres(t_world)}, m_lights{m_world.lights()}, m_camera{std::move(t_camera)},
+          m_grid{make_grid(m_world, t_grid_resolution)}, m_image{m_camera.image_width, m_camera.image_height()}
+    {
+        if (m_camera.indirect_cache) {
+            throw std::invalid_argument{"Sessions cannot render with a radiance cache"};
+        }
+
+        for (const auto &obj : m_world.objects) {
+            auto *s = static_cast<sphere<T> *>(obj.get());
+            m_ids[s] = m_spheres.size();
+            m_spheres.push_back(s);
+        }
+
+        for (auto y0 = 0; y0 < m_image.height(); y0 += t_tile_size) {
+            for (auto x0 = 0; x0 < m_image.width(); x0 += t_tile_size) {
+                m_tiles.push_back({x0, y0, std::min(t_tile_size, m_image.width() - x0), std::min(t_tile_size, m_image.height() - y0),
+                                   index_set{m_spheres.size()}, index_set{m_grid.cell_count()}});
+            }
+        }
+
+        render(std::vector<bool>(m_tiles.size(), true));
+    }
+
+    auto image() const -> const framebuffer<T> &
+    {
+        return m_image;
+    }
+
+    auto sphere_count() const -> std::size_t
+    {
+        return m_spheres.size();
+    }
+
+    auto sphere_at(const std::size_t index) const -> const sphere<T> &
+    {
+        return *m_spheres.at(index);
+    }
+
+    /// Moves or resizes a sphere
+    auto move_sphere(const std::size_t index, const coord<T> &center, const T radius) -> edit_stats
+    {
+        auto &s = *m_spheres.at(index);
+        const auto lo = static_cast<coord<T>>(center - vec3<T>{radius, radius, radius});
+        const auto hi = static_cast<coord<T>>(center + vec3<T>{radius, radius, radius});
+
+        // Paths that hit the sphere are affected, and so are the ones that went where the sphere is now
+        auto dirty = touching({index});
+        if (s.is_emissive() || !m_grid.contains(lo, hi)) {
+            dirty.assign(dirty.size(), true);
+        } else {
+            auto cells = index_set{m_grid.cell_count()};
+            m_grid.insert_box(lo, hi, cells);
+            for (auto t = std::size_t{0}; t < m_tiles.size(); ++t) {
+                dirty[t] = dirty[t] || m_tiles[t].cells.intersects(cells);
+            }
+        }
+
+        s.m_center = center;
+        s.m_radius = radius;
+        return render(dirty);
+    }
+
+    /// Assigns another material to a sphere
+    auto set_material(const std::size_t index, std::shared_ptr<material<T>> mat) -> edit_stats
+    {
+        auto &s = *m_spheres.at(index);
+        auto dirty = touching({index});
+        if (s.is_emissive() || mat->is_emissive()) {
+            dirty.assign(dirty.size(), true);
+        }
+
+        s.m_material = std::move(mat);
+        return render(dirty);
+    }
+
+    /// Replaces a material in every sphere using it, e.g. to tweak its parameters
+    auto replace_material(const material<T> *old_mat, const std::shared_ptr<material<T>> &new_mat) -> edit_stats
+    {
+        auto indices = std::vector<std::size_t>{};
+        for (auto i = std::size_t{0}; i < m_spheres.size(); ++i) {
+            if (m_spheres[i]->m_material.get() == old_mat) {
+                indices.push_back(i);
+            }
+        }
+
+        auto dirty = touching(indices);
+        if (old_mat->is_emissive() || new_mat->is_emissive()) {
+            dirty.assign(dirty.size(), true);
+        }
+
+        for (const auto i : indices) {
+            m_spheres[i]->m_material = new_mat;
+        }
+        return render(dirty);
+    }
+
+private:
+    struct tile
+    {
+        int x0;
+        int y0;
+        int width;
+        int height;
+        index_set objects;  // Spheres hit by any path of the tile
+        index_set cells;    // Grid cells crossed by any path of the tile
+    };
+
+    /// Records the dependencies of the tile being rendered
+    class recorder : public path_observer<T>
+    {
+    public:
+        recorder(const render_session &t_session, tile &t_tile) : m_session{t_session}, m_tile{t_tile} {}
+
+        auto on_segment(const ray<T> &r, const T t_end, const hittable<T> *object) -> void override
+        {
+            if (object) {
+                m_tile.objects.insert(m_session.m_ids.at(object));
+            }
+            m_session.m_grid.insert_segment(r, t_end, m_tile.cells);
+        }
+
+    private:
+        const render_session &m_session;
+        tile &m_tile;
+    };
+
+    hittable_list<T> m_world;
+    hittable_list<T> m_lights;
+    camera<T> m_camera;
+    tracking_grid<T> m_grid;
+    framebuffer<T> m_image;
+    std::vector<sphere<T> *> m_spheres;
+    std::unordered_map<const hittable<T> *, std::size_t> m_ids;
+    std::vector<tile> m_tiles;
+
+    /// @return Copy of every sphere of the world, sharing their materials
+    static auto copy_spheres(const hittable_list<T> &world) -> hittable_list<T>
+    {
+        hittable_list<T> copy;
+        for (const auto &obj : world.objects) {
+            const auto *s = dynamic_cast<const sphere<T> *>(obj.get());
+            if (!s) {
+                throw std::invalid_argument{"Only spheres can be edited in a session"};
+            }
+            copy.add(std::make_shared<sphere<T>>(*s));
+        }
+        return copy;
+    }
+
+    /// Grid around the spheres, except very large ones (e.g. a ground made of a huge sphere) which would
+    /// make the cells too coarse. Edits outside of the grid conservatively render everything again.
+    static auto make_grid(const hittable_list<T> &world, const int resolution) -> tracking_grid<T>
+    {
+        auto radii = std::vector<T>{};
+        for (const auto &obj : world.objects) {
+            if (const auto *s = dynamic_cast<const sphere<T> *>(obj.get())) {
+                radii.push_back(s->m_radius);
+            }
+        }
+        if (radii.empty()) {
+            throw std::invalid_argument{"Empty scene"};
+        }
+        std::ranges::nth_element(radii, radii.begin() + static_cast<std::ptrdiff_t>(radii.size() / 2));
+        const auto max_radius = 100 * radii[radii.size() / 2];
+
+        auto lo = coord<T>{rt::infinity, rt::infinity, rt::infinity};
+        auto hi = coord<T>{-rt::infinity, -rt::infinity, -rt::infinity};
+        for (const auto &obj : world.objects) {
+            const auto *s = dynamic_cast<const sphere<T> *>(obj.get());
+            if (s && s->m_radius <= max_radius) {
+                for (auto a = 0u; a < 3; ++a) {
+                    lo[a] = std::min(lo[a], s->m_center[a] - s->m_radius);
+                    hi[a] = std::max(hi[a], s->m_center[a] + s->m_radius);
+                }
+            }
+        }
+
+        constexpr auto padding = 1e-3;
+        for (auto a = 0u; a < 3; ++a) {
+            lo[a] -= padding;
+            hi[a] += padding;
+        }
+        return {lo, hi, resolution};
+    }
+
+    /// @return Flags of the tiles whose paths hit any of the given spheres
+    auto touching(const std::vector<std::size_t> &indices) const -> std::vector<bool>
+    {
+        auto dirty = std::vector<bool>(m_tiles.size(), false);
+        for (auto t = std::size_t{0}; t < m_tiles.size(); ++t) {
+            dirty[t] = std::ranges::any_of(indices, [&](const auto i) { return m_tiles[t].objects.contains(i); });
+        }
+        return dirty;
+    }
+
+    /// Renders the flagged tiles again, from scratch, recording their new dependencies
+    auto render(const std::vector<bool> &dirty) -> edit_stats
+    {
+        m_lights = m_world.lights();
+
+        auto stats = edit_stats{0, m_tiles.size(), dirty};
+        for (auto t = std::size_t{0}; t < m_tiles.size(); ++t) {
+            if (!dirty[t]) {
+                continue;
+            }
+
+            auto &tl = m_tiles[t];
+            tl.objects.clear();
+            tl.cells.clear();
+
+            auto pixels = framebuffer<T>{tl.width, tl.height};
+            auto observer = recorder{*this, tl};
+            m_camera.render_tile(tl.x0, tl.y0, m_world, m_lights, pixels, &observer);
+            m_image.paste(tl.x0, tl.y0, pixels);
+            ++stats.tiles_rendered;
+        }
+        return stats;
+    }
+};
\ No newline at end of file
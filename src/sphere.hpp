@@ -4,6 +4,9 @@
 
 #include "hittable.hpp"
 #include "material.hpp"
+#include "onb.hpp"
+#include "random.hpp"
+#include "rtweekend.hpp"
 
 template <typename T>
 class sphere : public hittable<T>
@@ -15,7 +18,69 @@ public:
         : m_center{std::move(t_center)}, m_radius{t_radius}, m_material{t_material}
     {}
 
-    auto hit(ray<T> r, interval<T> ray_t) const -> std::optional<hit_record<T>> override 
+    auto closest_hit(const ray<T> &r, const interval<T> ray_t) const -> std::optional<hit_candidate<T>> override 
+    {
+        if (const auto root = find_root(r, ray_t)) {
+            return hit_candidate<T>{*root, this};
+        }
+        return std::nullopt;
+    }
+
+    auto finalize(const ray<T> &r, const hit_candidate<T> candidate) const -> hit_record<T> override
+    {
+        const auto pos = r.at(candidate.t);
+
+        // The hit position lies at distance m_radius from the center, so no further normalization is needed
+        const auto outward_normal = static_cast<vec3<T>>((pos - m_center) / m_radius);
+        return hit_record<T>{r, candidate.t, pos, outward_normal, m_material.get()};
+    }
+
+    auto any_hit(const ray<T> &r, const interval<T> ray_t) const -> bool override
+    {
+        return find_root(r, ray_t).has_value();
+    }
+
+    auto pdf_value(const coord<T> &origin, const vec3<T> &direction) const -> T override
+    {
+        // Only valid if the origin lies outside of the sphere
+        if (!any_hit({origin, direction}, {rt::surface_epsilon, rt::infinity})) {
+            return 0;
+        }
+
+        const auto distance_squared = (m_center - origin).length_squared();
+        if (distance_squared <= m_radius * m_radius) {
+            return 0;
+        }
+
+        const auto cos_theta_max = std::sqrt(1 - m_radius * m_radius / distance_squared);
+        const auto solid_angle = 2 * rt::pi * (1 - cos_theta_max);
+        return 1 / solid_angle;
+    }
+
+    auto random(const coord<T> &origin) const -> vec3<T> override
+    {
+        const auto direction = m_center - origin;
+        const auto uvw = onb<T>{direction};
+        return uvw.local(rt::random_vec_to_sphere(m_radius, direction.length_squared()));
+    }
+
+    auto is_emissive() const -> bool override
+    {
+        return m_material->is_emissive();
+    }
+
+    auto emitted() const -> color<T> override
+    {
+        return m_material->emitted();
+    }
+
+    coord<T> m_center;
+    T m_radius;
+    material_type m_material;
+
+private:
+    /// @return Closest root of the ray-sphere equation within ray_t, if any
+    auto find_root(const ray<T> &r, const interval<T> ray_t) const -> std::optional<T>
     {
         const auto sqr = [](const auto v) {
             return v * v;
@@ -32,24 +97,10 @@ public:
         }
         const auto sqrtd = std::sqrt(discriminant);
 
-        const auto find_root_in_range = [&]() {
-            auto root = (-half_b - sqrtd) / a;
-            if (!ray_t.surrounds(root)) {
-                root = (-half_b + sqrtd) / a;
-            }
-            return ray_t.surrounds(root) ? std::optional<T>{root} : std::nullopt;
-        };
-
-        if (const auto root = find_root_in_range()) {
-            const auto pos = r.at(*root);
-            const auto outward_normal = static_cast<vec3<T>>((pos - m_center) / m_radius).unit_vector();
-            return hit_record{std::move(r), *root, outward_normal, m_material};
+        auto root = (-half_b - sqrtd) / a;
+        if (!ray_t.surrounds(root)) {
+            root = (-half_b + sqrtd) / a;
         }
-
-        return std::nullopt;
+        return ray_t.surrounds(root) ? std::optional<T>{root} : std::nullopt;
     }
-
-    coord<T> m_center;
-    T m_radius;
-    material_type m_material;
 };
\ No newline at end of file
@@ -4,15 +4,17 @@
 
 #include <algorithm>
 #include <array>
-#include <initializer_list>
 #include <iostream>
 #include <numeric>
 #include <optional>
 #include <type_traits>
-#include <stdexcept>
 
 #include "rtweekend.hpp"
 
+#ifdef RT_INSTRUMENT
+#include "instrumentation.hpp"
+#endif
+
 template <typename T>
 concept IsScalar = std::is_scalar_v<T>;
 
@@ -27,15 +29,21 @@ public:
 
     vec3(): vec3{T{}, T{}, T{}} {}
 
-    vec3(std::initializer_list<T> l) 
+    vec3(const T x, const T y, const T z) : e{x, y, z} {}
+
+#ifdef RT_INSTRUMENT
+    vec3(const vec3 &v) : e{v.e}
     {
-        if (l.size() > 3) {
-            throw std::invalid_argument{"Too many arguments"};
-        }
-        std::copy(l.begin(), l.end(), e.begin());
+        rt::instrumentation::count_copy(sizeof(vec3));
     }
 
-    virtual ~vec3() = default;
+    auto operator=(const vec3 &v) -> vec3 &
+    {
+        e = v.e;
+        rt::instrumentation::count_copy(sizeof(vec3));
+        return *this;
+    }
+#endif
 
     auto x() const -> T
     {
@@ -82,7 +90,7 @@ public:
         return {-e[0], -e[1], -e[2]}; 
     }
 
-    auto operator+=(const vec3 v) -> vec3 & 
+    auto operator+=(const vec3 &v) -> vec3 & 
     {
         e[0] += v[0];
         e[1] += v[1];
@@ -90,13 +98,15 @@ public:
         return *this;
     }
 
-    auto operator-=(const vec3 v) -> vec3 & 
+    auto operator-=(const vec3 &v) -> vec3 & 
     {
-        *this += -v;
+        e[0] -= v[0];
+        e[1] -= v[1];
+        e[2] -= v[2];
         return *this;
     }
 
-    auto operator*=(const vec3<T> v) -> vec3 &
+    auto operator*=(const vec3<T> &v) -> vec3 &
     {
         e[0] *= v[0];
         e[1] *= v[1];
@@ -146,27 +156,27 @@ public:
 };
 
 template <typename T>
-inline auto operator<<(std::ostream &out, const vec3<T> v) -> std::ostream &
+inline auto operator<<(std::ostream &out, const vec3<T> &v) -> std::ostream &
 {
     return out << v.e[0] << ' ' << v.e[1] << ' ' << v.e[2];
 }
 
 template <typename T>
-inline auto operator+(vec3<T> lhs, const vec3<T> rhs) -> vec3<T> 
+inline auto operator+(vec3<T> lhs, const vec3<T> &rhs) -> vec3<T> 
 {
     lhs += rhs;
     return lhs;
 }
 
 template <typename T>
-inline auto operator-(vec3<T> lhs, const vec3<T> rhs) -> vec3<T> 
+inline auto operator-(vec3<T> lhs, const vec3<T> &rhs) -> vec3<T> 
 {
     lhs -= rhs;
     return lhs;
 }
 
 template <typename T>
-inline auto operator*(vec3<T> lhs, const vec3<T> rhs) -> vec3<T> 
+inline auto operator*(vec3<T> lhs, const vec3<T> &rhs) -> vec3<T> 
 {
     lhs *= rhs;
     return lhs;
@@ -193,14 +203,13 @@ inline auto operator/(vec3<T> v, const U u) -> vec3<T>
 }
 
 template <typename T>
-inline auto dot(const vec3<T> lhs, const vec3<T> rhs) -> T 
+inline auto dot(const vec3<T> &lhs, const vec3<T> &rhs) -> T 
 {
-    const auto product = lhs * rhs;
-    return std::accumulate(product.e.begin(), product.e.end(), T{});
+    return lhs.e[0] * rhs.e[0] + lhs.e[1] * rhs.e[1] + lhs.e[2] * rhs.e[2];
 }
 
 template <typename T>
-inline auto cross(const vec3<T> u, const vec3<T> v) -> vec3<T> 
+inline auto cross(const vec3<T> &u, const vec3<T> &v) -> vec3<T> 
 {
     return {u.e[1] * v.e[2] - u.e[2] * v.e[1],
             u.e[2] * v.e[0] - u.e[0] * v.e[2],
@@ -208,13 +217,13 @@ inline auto cross(const vec3<T> u, const vec3<T> v) -> vec3<T>
 }
 
 template <typename T>
-inline auto reflect(const vec3<T> v, const vec3<T> n) -> vec3<T>
+inline auto reflect(const vec3<T> &v, const vec3<T> &n) -> vec3<T>
 {
     return v - 2 * dot(v, n) * n;
 }
 
 template <typename T>
-inline auto refract(const vec3<T> uv, const vec3<T> n, const double etai_over_etat) -> std::optional<vec3<T>>
+inline auto refract(const vec3<T> &uv, const vec3<T> &n, const double etai_over_etat) -> std::optional<vec3<T>>
 {
     const auto cos_theta = std::min(dot(-uv, n), 1.);
     const auto sin_theta = std::sqrt(1. - cos_theta * cos_theta);
@@ -234,6 +243,6 @@ class coord : public vec3<T>
 {
 public:
     coord() = default;
-    coord(std::initializer_list<T> l) : vec3<T>{l} {}
+    coord(const T x, const T y, const T z) : vec3<T>{x, y, z} {}
     explicit coord(vec3<T> v) : vec3<T>{std::move(v)} {};
 };
\ No newline at end of file